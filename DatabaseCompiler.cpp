@@ -0,0 +1,44 @@
+// C++ Libraries
+#include <iostream>
+
+// Qt Libraries
+#include <QString>
+
+// Custom Libraries
+#include "Enum.hpp"
+#include "HexDatabase.hpp"
+
+template<quint32 Number>
+static bool Compile(const QString& textPath, const QString& compiledPath, qsizetype classFieldFirst, qsizetype classFieldLast)
+{
+	auto database = HexDatabase<Number>(textPath, compiledPath, classFieldFirst, classFieldLast);
+	
+	if (not database.loadText())
+	{
+		std::cerr << "Cannot read " << textPath.toStdString() << "." << std::endl;
+		return false;
+	}
+	
+	if (database.getMismatches() != 0u)
+	{
+		std::cerr << textPath.toStdString() << " does not match Enum.hpp, nothing written." << std::endl;
+		return false;
+	}
+	
+	if (not database.compile())
+	{
+		std::cerr << "Cannot write " << compiledPath.toStdString() << "." << std::endl;
+		return false;
+	}
+	
+	std::cout << compiledPath.toStdString() << ": " << database.getFiles().size() << " records." << std::endl;
+	return true;
+}
+
+int main(void)
+{
+	const auto spells = Compile<static_cast<quint32>(SpellEnum::SIZE)>("files/spells.txt", "files/spells.hexdb", SpellClassFieldFirst, SpellClassFieldLast);
+	const auto powers = Compile<static_cast<quint32>(PowerEnum::SIZE)>("files/powers.txt", "files/powers.hexdb", PowerClassFieldFirst, PowerClassFieldLast);
+	
+	return (spells and powers ? 0 : 1);
+}
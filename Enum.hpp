@@ -361,6 +361,10 @@ enum class SpellEnum : quint32
 	SIZE
 };
 
+// Info fields of spells.txt holding "class level" lists: core, base and prestige classes, levels and domains.
+static constexpr qsizetype SpellClassFieldFirst = 1;
+static constexpr qsizetype SpellClassFieldLast = 5;
+
 enum class PowerEnum : quint32
 {
 	CLAIRSENTIENCE,
@@ -573,4 +577,8 @@ enum class PowerEnum : quint32
 	SIZE
 };
 
+// Info fields of powers.txt holding "class level" lists: base and prestige classes, levels and mantles.
+static constexpr qsizetype PowerClassFieldFirst = 1;
+static constexpr qsizetype PowerClassFieldLast = 4;
+
 #endif
@@ -0,0 +1,71 @@
+#ifndef __HEX_BATCH_QUEUE_HPP__
+#define __HEX_BATCH_QUEUE_HPP__
+
+// C++ Libraries
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+// Lock-free queue for any number of producers and a single consumer.
+// Producers push onto an atomic list; the consumer detaches the whole list at once, so there is never a node to contend for.
+template<typename Type>
+class HexBatchQueue
+{
+	private:
+	
+		struct Node
+		{
+			Type				value;
+			Node*				next;
+		};
+		
+		std::atomic<Node*>			head = nullptr;
+	
+	public:
+	
+		inline					HexBatchQueue(void) = default;
+		inline					HexBatchQueue(const HexBatchQueue&) = delete;
+		inline					~HexBatchQueue(void);
+		
+		inline HexBatchQueue&			operator=(const HexBatchQueue&) = delete;
+		
+		inline void				push(Type&&);
+		inline std::vector<Type>		takeAll(void);
+};
+
+template<typename Type>
+HexBatchQueue<Type>::~HexBatchQueue(void)
+{
+	HexBatchQueue::takeAll();
+}
+
+template<typename Type>
+void HexBatchQueue<Type>::push(Type&& value)
+{
+	const auto node = new Node{ std::move(value), HexBatchQueue::head.load(std::memory_order_relaxed) };
+	
+	while (not HexBatchQueue::head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed));
+}
+
+// Returns the values in the order they were pushed.
+template<typename Type>
+std::vector<Type> HexBatchQueue<Type>::takeAll(void)
+{
+	auto node = HexBatchQueue::head.exchange(nullptr, std::memory_order_acquire);
+	auto result = std::vector<Type>();
+	
+	while (node != nullptr)
+	{
+		const auto next = node->next;
+		
+		result.push_back(std::move(node->value));
+		delete node;
+		node = next;
+	}
+	
+	std::reverse(result.begin(), result.end());
+	return result;
+}
+
+#endif
@@ -0,0 +1,209 @@
+#ifndef __HEX_BITMAP_HPP__
+#define __HEX_BITMAP_HPP__
+
+// C++ Libraries
+#include <bit>
+#include <vector>
+
+// Qt Libraries
+#include <QtGlobal>
+
+// One bit per record of a database.
+class HexBitmap
+{
+	private:
+	
+		std::vector<quint64>				words;
+		quint32						records = 0u;
+	
+	public:
+	
+		inline						HexBitmap(void);
+		inline						HexBitmap(quint32, bool);
+		
+		inline static HexBitmap				FromIndices(const std::vector<quint32>&, quint32);
+		
+		inline bool					any(void) const;
+		inline quint32					count(void) const;
+		inline quint64*					data(void);
+		inline const quint64*				data(void) const;
+		template<typename Function> inline void		forEach(Function) const;
+		template<typename Function> inline void		forEach(Function, quint32, quint32) const;
+		inline void					intersect(const HexBitmap&);
+		inline quint32					intersectionCount(const HexBitmap&) const;
+		template<typename Function> inline void		retain(Function);
+		template<typename Function> inline void		retain(Function, quint32, quint32);
+		inline void					setBit(quint32);
+		inline quint32					size(void) const;
+		inline void					subtract(const HexBitmap&);
+		inline bool					testBit(quint32) const;
+		inline std::vector<quint32>			toIndices(void) const;
+		inline void					unite(const HexBitmap&);
+		inline quint32					wordCount(void) const;
+};
+
+HexBitmap::HexBitmap(void)
+{
+}
+
+HexBitmap::HexBitmap(quint32 size, bool filled) : words((size + 63u)/64u, (filled ? compl(0llu) : 0llu)), records(size)
+{
+	if (filled and size % 64u != 0u)
+		HexBitmap::words.back() = (1llu << (size % 64u)) - 1llu;
+}
+
+HexBitmap HexBitmap::FromIndices(const std::vector<quint32>& indices, quint32 size)
+{
+	auto result = HexBitmap(size, false);
+	
+	for (const auto index : indices)
+		result.setBit(index);
+	
+	return result;
+}
+
+bool HexBitmap::any(void) const
+{
+	for (const auto u : HexBitmap::words)
+	{
+		if (u != 0llu)
+			return true;
+	}
+	
+	return false;
+}
+
+quint32 HexBitmap::count(void) const
+{
+	auto result = 0u;
+	
+	for (const auto u : HexBitmap::words)
+		result += static_cast<quint32>(std::popcount(u));
+	
+	return result;
+}
+
+quint64* HexBitmap::data(void)
+{
+	return HexBitmap::words.data();
+}
+
+const quint64* HexBitmap::data(void) const
+{
+	return HexBitmap::words.data();
+}
+
+template<typename Function>
+void HexBitmap::forEach(Function function) const
+{
+	HexBitmap::forEach(function, 0u, HexBitmap::wordCount());
+}
+
+template<typename Function>
+void HexBitmap::forEach(Function function, quint32 first, quint32 last) const
+{
+	for (auto i = first; i < last; ++i)
+	{
+		for (auto u = HexBitmap::words[i]; u != 0llu; u &= u - 1llu)
+			function(64u*i + static_cast<quint32>(std::countr_zero(u)));
+	}
+}
+
+void HexBitmap::intersect(const HexBitmap& b)
+{
+	auto it = b.words.cbegin();
+	
+	for (auto& u : HexBitmap::words)
+	{
+		u &= *it;
+		++it;
+	}
+}
+
+// Records set in both bitmaps, without building their intersection.
+quint32 HexBitmap::intersectionCount(const HexBitmap& b) const
+{
+	auto result = 0u;
+	
+	for (auto i = std::size_t(0u); i < HexBitmap::words.size(); ++i)
+		result += static_cast<quint32>(std::popcount(HexBitmap::words[i] & b.words[i]));
+	
+	return result;
+}
+
+template<typename Function>
+void HexBitmap::retain(Function function)
+{
+	HexBitmap::retain(function, 0u, HexBitmap::wordCount());
+}
+
+// Clears every set bit of words [first, last) whose index fails the test. Disjoint word ranges can be handled by different threads.
+template<typename Function>
+void HexBitmap::retain(Function function, quint32 first, quint32 last)
+{
+	for (auto i = first; i < last; ++i)
+	{
+		auto& word = HexBitmap::words[i];
+		
+		for (auto u = word; u != 0llu; u &= u - 1llu)
+		{
+			const auto bit = static_cast<quint32>(std::countr_zero(u));
+			
+			if (not function(64u*i + bit))
+				word &= compl(1llu << bit);
+		}
+	}
+}
+
+void HexBitmap::setBit(quint32 k)
+{
+	HexBitmap::words[k/64u] |= (1llu << (k % 64u));
+}
+
+quint32 HexBitmap::size(void) const
+{
+	return HexBitmap::records;
+}
+
+void HexBitmap::subtract(const HexBitmap& b)
+{
+	auto it = b.words.cbegin();
+	
+	for (auto& u : HexBitmap::words)
+	{
+		u &= compl(*it);
+		++it;
+	}
+}
+
+bool HexBitmap::testBit(quint32 k) const
+{
+	return static_cast<bool>((HexBitmap::words[k/64u] >> (k % 64u)) & 1llu);
+}
+
+std::vector<quint32> HexBitmap::toIndices(void) const
+{
+	auto result = std::vector<quint32>();
+	result.reserve(HexBitmap::count());
+	
+	HexBitmap::forEach([&result](quint32 k) { result.push_back(k); });
+	return result;
+}
+
+void HexBitmap::unite(const HexBitmap& b)
+{
+	auto it = b.words.cbegin();
+	
+	for (auto& u : HexBitmap::words)
+	{
+		u |= *it;
+		++it;
+	}
+}
+
+quint32 HexBitmap::wordCount(void) const
+{
+	return static_cast<quint32>(HexBitmap::words.size());
+}
+
+#endif
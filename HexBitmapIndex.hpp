@@ -0,0 +1,129 @@
+#ifndef __HEX_BITMAP_INDEX_HPP__
+#define __HEX_BITMAP_INDEX_HPP__
+
+// C++ Libraries
+#include <bit>
+#include <vector>
+
+// Custom Libraries
+#include "HexBitmap.hpp"
+#include "HexBitset.hpp"
+#include "HexFile.hpp"
+
+// Transposed view of a database: for every flag, the bitmap of the records carrying it, and how many records that is.
+// A query then costs a few word-wide operations per selected button, whatever the number of records.
+// Groups selecting so many flags that merging their columns would cost more than a pass over the rows use the batch kernels instead.
+template<quint32 Number>
+class HexBitmapIndex
+{
+	private:
+	
+		static constexpr quint64			WordsPerRow = 5llu;
+		
+		std::vector<HexBitmap>				columns;
+		std::vector<quint32>				frequencies;
+		std::vector<quint64>				rows;
+		quint32						records = 0u;
+	
+	public:
+	
+		template<typename Function> inline static void	ForEachBit(const HexBitset<Number>&, Function);
+		inline static quint32				Weight(const HexBitset<Number>&);
+		
+		inline void					build(const std::vector<HexFile<Number>>&);
+		inline const HexBitmap&				column(quint32) const;
+		inline HexBitmap				filter(HexPredicate, const HexBitset<Number>&) const;
+		inline quint32					frequency(quint32) const;
+		inline bool					prefersRows(const HexBitset<Number>&) const;
+		inline quint32					size(void) const;
+		inline quint32					wordCount(void) const;
+};
+
+template<quint32 Number>
+template<typename Function>
+void HexBitmapIndex<Number>::ForEachBit(const HexBitset<Number>& bitset, Function function)
+{
+	const auto words = bitset.data();
+	
+	for (auto i = 0u; i < HexBitset<Number>::ARRAY_SIZE; ++i)
+	{
+		for (auto u = words[i]; u != 0llu; u &= u - 1llu)
+			function(64u*i + static_cast<quint32>(std::countr_zero(u)));
+	}
+}
+
+template<quint32 Number>
+void HexBitmapIndex<Number>::build(const std::vector<HexFile<Number>>& files)
+{
+	HexBitmapIndex::records = static_cast<quint32>(files.size());
+	HexBitmapIndex::columns.assign(Number, HexBitmap(HexBitmapIndex::records, false));
+	HexBitmapIndex::rows.clear();
+	HexBitmapIndex::rows.reserve(static_cast<quint64>(HexBitmapIndex::records)*HexBitset<Number>::ARRAY_SIZE);
+	
+	for (auto index = 0u; index < HexBitmapIndex::records; ++index)
+	{
+		const auto& bits = files[index].bits;
+		
+		HexBitmapIndex::ForEachBit(bits, [this, index](quint32 bit) { HexBitmapIndex::columns[bit].setBit(index); });
+		HexBitmapIndex::rows.insert(HexBitmapIndex::rows.end(), bits.data(), bits.data() + HexBitset<Number>::ARRAY_SIZE);
+	}
+	
+	HexBitmapIndex::frequencies.clear();
+	HexBitmapIndex::frequencies.reserve(Number);
+	
+	for (const auto& column : HexBitmapIndex::columns)
+		HexBitmapIndex::frequencies.push_back(column.count());
+}
+
+template<quint32 Number>
+const HexBitmap& HexBitmapIndex<Number>::column(quint32 bit) const
+{
+	return HexBitmapIndex::columns[bit];
+}
+
+template<quint32 Number>
+HexBitmap HexBitmapIndex<Number>::filter(HexPredicate predicate, const HexBitset<Number>& query) const
+{
+	auto result = HexBitmap(HexBitmapIndex::records, false);
+	
+	HexBitsetKernels::Filter(predicate, HexBitmapIndex::rows.data(), HexBitmapIndex::records, HexBitset<Number>::ARRAY_SIZE, query.data(), result.data());
+	return result;
+}
+
+template<quint32 Number>
+quint32 HexBitmapIndex<Number>::frequency(quint32 bit) const
+{
+	return HexBitmapIndex::frequencies[bit];
+}
+
+// Measured on the spell database (2555 records, 40-word columns): a row costs about 2.3 ns, a column word about 0.47 ns, so merging wins below some 320 flags.
+template<quint32 Number>
+bool HexBitmapIndex<Number>::prefersRows(const HexBitset<Number>& query) const
+{
+	return (static_cast<quint64>(HexBitmapIndex::Weight(query))*HexBitmapIndex::wordCount() > HexBitmapIndex::WordsPerRow*HexBitmapIndex::records);
+}
+
+template<quint32 Number>
+quint32 HexBitmapIndex<Number>::size(void) const
+{
+	return HexBitmapIndex::records;
+}
+
+template<quint32 Number>
+quint32 HexBitmapIndex<Number>::wordCount(void) const
+{
+	return (HexBitmapIndex::records + 63u)/64u;
+}
+
+template<quint32 Number>
+quint32 HexBitmapIndex<Number>::Weight(const HexBitset<Number>& bitset)
+{
+	auto result = 0u;
+	
+	for (auto i = 0u; i < HexBitset<Number>::ARRAY_SIZE; ++i)
+		result += static_cast<quint32>(std::popcount(bitset.data()[i]));
+	
+	return result;
+}
+
+#endif
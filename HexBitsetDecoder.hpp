@@ -0,0 +1,175 @@
+#ifndef __HEX_BITSET_DECODER_HPP__
+#define __HEX_BITSET_DECODER_HPP__
+
+// C++ Libraries
+#include <bit>
+
+#if defined(__x86_64__) and (defined(__GNUC__) or defined(__clang__))
+#define HEX_RUNTIME_DISPATCH
+#include <immintrin.h>
+#endif
+
+// Qt Libraries
+#include <QtGlobal>
+
+// Turns a string of '0'/'1' flags (most significant flag first) into bitset words.
+// The widest kernel the processor supports is picked once, the first time the decoder is used.
+class HexBitsetDecoder
+{
+	private:
+	
+		using Kernel = void (*)(const char*, qsizetype, quint64*);
+		
+		inline static quint64				Reverse(quint64);
+		inline static void				DecodeScalar(const char*, qsizetype, quint64*);
+		inline static Kernel				Select(void);
+
+#ifdef HEX_RUNTIME_DISPATCH
+		[[gnu::target("avx2")]] inline static void	DecodeAVX2(const char*, qsizetype, quint64*);
+		[[gnu::target("avx512f,avx512bw")]] inline static void	DecodeAVX512(const char*, qsizetype, quint64*);
+		inline static void				DecodeSSE2(const char*, qsizetype, quint64*);
+#endif
+
+	public:
+	
+		inline static void				Decode(const char*, qsizetype, quint32, quint64*);
+		inline static const char*			InstructionSet(void);
+};
+
+void HexBitsetDecoder::Decode(const char* digits, qsizetype size, quint32 number, quint64* words)
+{
+	static const auto kernel = HexBitsetDecoder::Select();
+	
+	if (size > static_cast<qsizetype>(number))
+	{
+		digits += size - number;
+		size = number;
+	}
+	
+	kernel(digits, size, words);
+}
+
+void HexBitsetDecoder::DecodeScalar(const char* digits, qsizetype size, quint64* words)
+{
+	auto byte = 1llu;
+	
+	for (auto it = digits + size; it != digits; --it)
+	{
+		if (*(it - 1) != '0')
+			*words |= byte;
+		
+		byte <<= 1llu;
+		
+		if (byte == 0llu)
+		{
+			byte = 1llu;
+			++words;
+		}
+	}
+}
+
+const char* HexBitsetDecoder::InstructionSet(void)
+{
+#ifdef HEX_RUNTIME_DISPATCH
+	if (__builtin_cpu_supports("avx512bw"))
+		return "AVX-512";
+	
+	if (__builtin_cpu_supports("avx2"))
+		return "AVX2";
+	
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
+
+quint64 HexBitsetDecoder::Reverse(quint64 u)
+{
+	u = std::byteswap(u);
+	u = ((u >> 1llu) & 0x5555555555555555llu) | ((u & 0x5555555555555555llu) << 1llu);
+	u = ((u >> 2llu) & 0x3333333333333333llu) | ((u & 0x3333333333333333llu) << 2llu);
+	u = ((u >> 4llu) & 0x0F0F0F0F0F0F0F0Fllu) | ((u & 0x0F0F0F0F0F0F0F0Fllu) << 4llu);
+	
+	return u;
+}
+
+HexBitsetDecoder::Kernel HexBitsetDecoder::Select(void)
+{
+#ifdef HEX_RUNTIME_DISPATCH
+	__builtin_cpu_init();
+	
+	if (__builtin_cpu_supports("avx512bw"))
+		return HexBitsetDecoder::DecodeAVX512;
+	
+	if (__builtin_cpu_supports("avx2"))
+		return HexBitsetDecoder::DecodeAVX2;
+	
+	return HexBitsetDecoder::DecodeSSE2;
+#else
+	return HexBitsetDecoder::DecodeScalar;
+#endif
+}
+
+#ifdef HEX_RUNTIME_DISPATCH
+// Each step reads the 64 last flags still pending: the movemask puts the first character in bit 0, hence the final reversal.
+void HexBitsetDecoder::DecodeSSE2(const char* digits, qsizetype size, quint64* words)
+{
+	const auto zeros = _mm_set1_epi8('0');
+	auto end = digits + size;
+	
+	while (end - digits >= 64)
+	{
+		end -= 64;
+		auto mask = 0llu;
+		
+		for (auto i = 0; i < 4; ++i)
+		{
+			const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(end + 16*i));
+			mask |= static_cast<quint64>(static_cast<quint16>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, zeros)))) << (16llu*i);
+		}
+		
+		*(words++) = HexBitsetDecoder::Reverse(compl(mask));
+	}
+	
+	HexBitsetDecoder::DecodeScalar(digits, end - digits, words);
+}
+
+void HexBitsetDecoder::DecodeAVX2(const char* digits, qsizetype size, quint64* words)
+{
+	const auto zeros = _mm256_set1_epi8('0');
+	auto end = digits + size;
+	
+	while (end - digits >= 64)
+	{
+		end -= 64;
+		
+		const auto low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(end));
+		const auto high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(end + 32));
+		
+		const auto lowMask = static_cast<quint64>(static_cast<quint32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, zeros))));
+		const auto highMask = static_cast<quint64>(static_cast<quint32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, zeros))));
+		
+		*(words++) = HexBitsetDecoder::Reverse(compl(lowMask | (highMask << 32llu)));
+	}
+	
+	HexBitsetDecoder::DecodeScalar(digits, end - digits, words);
+}
+
+void HexBitsetDecoder::DecodeAVX512(const char* digits, qsizetype size, quint64* words)
+{
+	const auto zeros = _mm512_set1_epi8('0');
+	auto end = digits + size;
+	
+	while (end - digits >= 64)
+	{
+		end -= 64;
+		
+		const auto block = _mm512_loadu_si512(end);
+		*(words++) = HexBitsetDecoder::Reverse(_mm512_cmpneq_epi8_mask(block, zeros));
+	}
+	
+	HexBitsetDecoder::DecodeScalar(digits, end - digits, words);
+}
+#endif
+
+#endif
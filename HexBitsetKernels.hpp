@@ -0,0 +1,317 @@
+#ifndef __HEX_BITSET_KERNELS_HPP__
+#define __HEX_BITSET_KERNELS_HPP__
+
+// C++ Libraries
+#include <algorithm>
+
+#if defined(__x86_64__) and (defined(__GNUC__) or defined(__clang__))
+#define HEX_RUNTIME_DISPATCH
+#include <immintrin.h>
+#endif
+
+// Qt Libraries
+#include <QtGlobal>
+
+enum class HexPredicate
+{
+	All,
+	Any,
+	None
+};
+
+// Set tests between a row of bitset words and a query of the same width.
+// The table is filled once with the widest kernels the processor supports; null(row) is none(row, row).
+class HexBitsetKernels
+{
+	private:
+	
+		using Test = bool (*)(const quint64*, const quint64*, quint32);
+		using Batch = void (*)(const quint64*, quint32, quint32, const quint64*, quint64*);
+		
+		struct Table
+		{
+			Test					all;
+			Test					any;
+			Test					none;
+			Batch					batchAll;
+			Batch					batchAny;
+			Batch					batchNone;
+			const char*				name;
+		};
+		
+		inline static const Table&		Dispatch(void);
+		inline static Table			Select(void);
+		
+		template<HexPredicate Predicate> inline static bool	TestScalar(const quint64*, const quint64*, quint32);
+		template<HexPredicate Predicate> inline static void	BatchScalar(const quint64*, quint32, quint32, const quint64*, quint64*);
+
+#ifdef HEX_RUNTIME_DISPATCH
+		template<HexPredicate Predicate> [[gnu::target("sse4.1")]] inline static bool		TestSSE41(const quint64*, const quint64*, quint32);
+		template<HexPredicate Predicate> [[gnu::target("sse4.1")]] inline static void		BatchSSE41(const quint64*, quint32, quint32, const quint64*, quint64*);
+		template<HexPredicate Predicate> [[gnu::target("avx2")]] inline static bool		TestAVX2(const quint64*, const quint64*, quint32);
+		template<HexPredicate Predicate> [[gnu::target("avx2")]] inline static void		BatchAVX2(const quint64*, quint32, quint32, const quint64*, quint64*);
+		template<HexPredicate Predicate> [[gnu::target("avx512f")]] inline static bool		TestAVX512(const quint64*, const quint64*, quint32);
+		template<HexPredicate Predicate> [[gnu::target("avx512f")]] inline static void		BatchAVX512(const quint64*, quint32, quint32, const quint64*, quint64*);
+#endif
+
+	public:
+	
+		inline static bool			All(const quint64*, const quint64*, quint32);
+		inline static bool			Any(const quint64*, const quint64*, quint32);
+		inline static void			Filter(HexPredicate, const quint64*, quint32, quint32, const quint64*, quint64*);
+		inline static const char*		InstructionSet(void);
+		inline static bool			None(const quint64*, const quint64*, quint32);
+		inline static bool			Null(const quint64*, quint32);
+};
+
+bool HexBitsetKernels::All(const quint64* row, const quint64* query, quint32 words)
+{
+	return HexBitsetKernels::Dispatch().all(row, query, words);
+}
+
+bool HexBitsetKernels::Any(const quint64* row, const quint64* query, quint32 words)
+{
+	return HexBitsetKernels::Dispatch().any(row, query, words);
+}
+
+const HexBitsetKernels::Table& HexBitsetKernels::Dispatch(void)
+{
+	static const auto table = HexBitsetKernels::Select();
+	return table;
+}
+
+// Tests `count` rows of `words` words laid out back to back, and writes bit i of `result` when row i passes.
+void HexBitsetKernels::Filter(HexPredicate predicate, const quint64* rows, quint32 count, quint32 words, const quint64* query, quint64* result)
+{
+	const auto& table = HexBitsetKernels::Dispatch();
+	
+	switch (predicate)
+	{
+		case HexPredicate::All:
+			table.batchAll(rows, count, words, query, result);
+			break;
+		
+		case HexPredicate::Any:
+			table.batchAny(rows, count, words, query, result);
+			break;
+		
+		case HexPredicate::None:
+			table.batchNone(rows, count, words, query, result);
+			break;
+	}
+}
+
+const char* HexBitsetKernels::InstructionSet(void)
+{
+	return HexBitsetKernels::Dispatch().name;
+}
+
+bool HexBitsetKernels::None(const quint64* row, const quint64* query, quint32 words)
+{
+	return HexBitsetKernels::Dispatch().none(row, query, words);
+}
+
+bool HexBitsetKernels::Null(const quint64* row, quint32 words)
+{
+	return HexBitsetKernels::Dispatch().none(row, row, words);
+}
+
+HexBitsetKernels::Table HexBitsetKernels::Select(void)
+{
+#ifdef HEX_RUNTIME_DISPATCH
+	__builtin_cpu_init();
+	
+	if (__builtin_cpu_supports("avx512f"))
+		return { TestAVX512<HexPredicate::All>, TestAVX512<HexPredicate::Any>, TestAVX512<HexPredicate::None>, BatchAVX512<HexPredicate::All>, BatchAVX512<HexPredicate::Any>, BatchAVX512<HexPredicate::None>, "AVX-512" };
+	
+	if (__builtin_cpu_supports("avx2"))
+		return { TestAVX2<HexPredicate::All>, TestAVX2<HexPredicate::Any>, TestAVX2<HexPredicate::None>, BatchAVX2<HexPredicate::All>, BatchAVX2<HexPredicate::Any>, BatchAVX2<HexPredicate::None>, "AVX2" };
+	
+	if (__builtin_cpu_supports("sse4.1"))
+		return { TestSSE41<HexPredicate::All>, TestSSE41<HexPredicate::Any>, TestSSE41<HexPredicate::None>, BatchSSE41<HexPredicate::All>, BatchSSE41<HexPredicate::Any>, BatchSSE41<HexPredicate::None>, "SSE4.1" };
+#endif
+
+	return { TestScalar<HexPredicate::All>, TestScalar<HexPredicate::Any>, TestScalar<HexPredicate::None>, BatchScalar<HexPredicate::All>, BatchScalar<HexPredicate::Any>, BatchScalar<HexPredicate::None>, "scalar" };
+}
+
+template<HexPredicate Predicate>
+bool HexBitsetKernels::TestScalar(const quint64* row, const quint64* query, quint32 words)
+{
+	for (auto i = 0u; i < words; ++i)
+	{
+		const auto u = row[i] & query[i];
+		
+		if constexpr (Predicate == HexPredicate::All)
+		{
+			if (u != query[i])
+				return false;
+		}
+		else if constexpr (Predicate == HexPredicate::Any)
+		{
+			if (u != 0llu)
+				return true;
+		}
+		else
+		{
+			if (u != 0llu)
+				return false;
+		}
+	}
+	
+	return (Predicate != HexPredicate::Any);
+}
+
+template<HexPredicate Predicate>
+void HexBitsetKernels::BatchScalar(const quint64* rows, quint32 count, quint32 words, const quint64* query, quint64* result)
+{
+	for (auto block = 0u; block < count; block += 64u)
+	{
+		const auto stop = std::min(count, block + 64u);
+		auto mask = 0llu;
+		
+		for (auto i = block; i < stop; ++i)
+			mask |= static_cast<quint64>(HexBitsetKernels::TestScalar<Predicate>(rows + static_cast<quint64>(i)*words, query, words)) << (i - block);
+		
+		result[block/64u] = mask;
+	}
+}
+
+#ifdef HEX_RUNTIME_DISPATCH
+// The odd word left by the 128-bit loop goes through the scalar test, which also yields the neutral answer when nothing is left.
+template<HexPredicate Predicate>
+bool HexBitsetKernels::TestSSE41(const quint64* row, const quint64* query, quint32 words)
+{
+	auto i = 0u;
+	
+	for (; i + 2u <= words; i += 2u)
+	{
+		const auto r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+		const auto q = _mm_loadu_si128(reinterpret_cast<const __m128i*>(query + i));
+		
+		if constexpr (Predicate == HexPredicate::All)
+		{
+			if (not _mm_testc_si128(r, q))
+				return false;
+		}
+		else if constexpr (Predicate == HexPredicate::Any)
+		{
+			if (not _mm_testz_si128(r, q))
+				return true;
+		}
+		else
+		{
+			if (not _mm_testz_si128(r, q))
+				return false;
+		}
+	}
+	
+	return HexBitsetKernels::TestScalar<Predicate>(row + i, query + i, words - i);
+}
+
+template<HexPredicate Predicate>
+void HexBitsetKernels::BatchSSE41(const quint64* rows, quint32 count, quint32 words, const quint64* query, quint64* result)
+{
+	for (auto block = 0u; block < count; block += 64u)
+	{
+		const auto stop = std::min(count, block + 64u);
+		auto mask = 0llu;
+		
+		for (auto i = block; i < stop; ++i)
+			mask |= static_cast<quint64>(HexBitsetKernels::TestSSE41<Predicate>(rows + static_cast<quint64>(i)*words, query, words)) << (i - block);
+		
+		result[block/64u] = mask;
+	}
+}
+
+template<HexPredicate Predicate>
+bool HexBitsetKernels::TestAVX2(const quint64* row, const quint64* query, quint32 words)
+{
+	auto i = 0u;
+	
+	for (; i + 4u <= words; i += 4u)
+	{
+		const auto r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+		const auto q = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(query + i));
+		
+		if constexpr (Predicate == HexPredicate::All)
+		{
+			if (not _mm256_testc_si256(r, q))
+				return false;
+		}
+		else if constexpr (Predicate == HexPredicate::Any)
+		{
+			if (not _mm256_testz_si256(r, q))
+				return true;
+		}
+		else
+		{
+			if (not _mm256_testz_si256(r, q))
+				return false;
+		}
+	}
+	
+	return HexBitsetKernels::TestSSE41<Predicate>(row + i, query + i, words - i);
+}
+
+template<HexPredicate Predicate>
+void HexBitsetKernels::BatchAVX2(const quint64* rows, quint32 count, quint32 words, const quint64* query, quint64* result)
+{
+	for (auto block = 0u; block < count; block += 64u)
+	{
+		const auto stop = std::min(count, block + 64u);
+		auto mask = 0llu;
+		
+		for (auto i = block; i < stop; ++i)
+			mask |= static_cast<quint64>(HexBitsetKernels::TestAVX2<Predicate>(rows + static_cast<quint64>(i)*words, query, words)) << (i - block);
+		
+		result[block/64u] = mask;
+	}
+}
+
+// Masked loads cover the tail, so a row of up to eight words is a single load and a single test.
+template<HexPredicate Predicate>
+bool HexBitsetKernels::TestAVX512(const quint64* row, const quint64* query, quint32 words)
+{
+	for (auto i = 0u; i < words; i += 8u)
+	{
+		const auto lanes = static_cast<__mmask8>(words - i >= 8u ? 0xFFu : (1u << (words - i)) - 1u);
+		const auto r = _mm512_maskz_loadu_epi64(lanes, row + i);
+		const auto q = _mm512_maskz_loadu_epi64(lanes, query + i);
+		
+		if constexpr (Predicate == HexPredicate::All)
+		{
+			if (_mm512_cmpneq_epi64_mask(_mm512_and_si512(r, q), q) != 0u)
+				return false;
+		}
+		else if constexpr (Predicate == HexPredicate::Any)
+		{
+			if (_mm512_test_epi64_mask(r, q) != 0u)
+				return true;
+		}
+		else
+		{
+			if (_mm512_test_epi64_mask(r, q) != 0u)
+				return false;
+		}
+	}
+	
+	return (Predicate != HexPredicate::Any);
+}
+
+template<HexPredicate Predicate>
+void HexBitsetKernels::BatchAVX512(const quint64* rows, quint32 count, quint32 words, const quint64* query, quint64* result)
+{
+	for (auto block = 0u; block < count; block += 64u)
+	{
+		const auto stop = std::min(count, block + 64u);
+		auto mask = 0llu;
+		
+		for (auto i = block; i < stop; ++i)
+			mask |= static_cast<quint64>(HexBitsetKernels::TestAVX512<Predicate>(rows + static_cast<quint64>(i)*words, query, words)) << (i - block);
+		
+		result[block/64u] = mask;
+	}
+}
+#endif
+
+#endif
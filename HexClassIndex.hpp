@@ -0,0 +1,236 @@
+#ifndef __HEX_CLASS_INDEX_HPP__
+#define __HEX_CLASS_INDEX_HPP__
+
+// C++ Libraries
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// Qt Libraries
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+
+// Custom Libraries
+#include "HexBitmap.hpp"
+
+// Records of every (class, level) pair read from the class lists of the info field, such as "Cleric 4, Sorcerer 4, Wizard 4".
+// Unlike the class and level bits, which lose the pairing, "cleric 4" only matches records a cleric gets at level 4.
+// A query is a comma separated list of a class followed by a level (4, =4), a bound (<= 3, ≤ 3, < 4, >= 2, ≥ 2, > 1), a range (2..4, 2-4) or nothing for any level; every term is required.
+class HexClassIndex
+{
+	private:
+	
+		struct Term
+		{
+			QString					name;
+			quint32					low;
+			quint32					high;
+		};
+		
+		inline static quint64			Key(quint32, quint32);
+		inline static bool			Parse(QStringView, Term&);
+		inline static bool			ParseBound(QStringView, quint32&);
+		
+		QHash<QString, quint32>			classes;
+		std::vector<quint64>			keys;
+		std::vector<quint32>			starts;
+		std::vector<quint32>			postings;
+		quint32					records = 0u;
+	
+	public:
+	
+		template<typename Function> inline void	build(quint32, qsizetype, qsizetype, Function);
+		inline bool				isValid(const QString&) const;
+		inline HexBitmap			match(const QString&) const;
+};
+
+// The function gives the info field of a record; the class lists are its fields first to last, separated by semicolons.
+template<typename Function>
+void HexClassIndex::build(quint32 count, qsizetype first, qsizetype last, Function infoOf)
+{
+	auto pairs = std::vector<std::pair<quint64, quint32>>();
+	
+	HexClassIndex::classes.clear();
+	HexClassIndex::records = count;
+	
+	for (auto record = 0u; record < count; ++record)
+	{
+		const auto fields = infoOf(record).split(';');
+		
+		for (auto field = first; field <= last and field < fields.size(); ++field)
+		{
+			for (const auto& item : fields.at(field).split(','))
+			{
+				auto term = Term();
+				
+				// Only "class level" items; a class list never leaves a level out.
+				if (not HexClassIndex::Parse(item, term) or term.low != term.high)
+					continue;
+				
+				const auto it = HexClassIndex::classes.constFind(term.name);
+				auto id = static_cast<quint32>(HexClassIndex::classes.size());
+				
+				if (HexClassIndex::classes.cend() == it)
+					HexClassIndex::classes.insert(term.name, id);
+				else
+					id = it.value();
+				
+				pairs.emplace_back(HexClassIndex::Key(id, term.low), record);
+			}
+		}
+	}
+	
+	std::sort(pairs.begin(), pairs.end());
+	pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+	
+	HexClassIndex::keys.clear();
+	HexClassIndex::starts.clear();
+	HexClassIndex::postings.clear();
+	HexClassIndex::postings.reserve(pairs.size());
+	
+	for (const auto& [key, record] : pairs)
+	{
+		if (HexClassIndex::keys.empty() or HexClassIndex::keys.back() != key)
+		{
+			HexClassIndex::keys.push_back(key);
+			HexClassIndex::starts.push_back(static_cast<quint32>(HexClassIndex::postings.size()));
+		}
+		
+		HexClassIndex::postings.push_back(record);
+	}
+	
+	HexClassIndex::starts.push_back(static_cast<quint32>(HexClassIndex::postings.size()));
+}
+
+// Whether every term of the query reads, and names a known class.
+bool HexClassIndex::isValid(const QString& query) const
+{
+	for (const auto& text : query.split(',', Qt::SkipEmptyParts))
+	{
+		auto term = Term();
+		
+		if (not HexClassIndex::Parse(text, term) or not HexClassIndex::classes.contains(term.name))
+			return false;
+	}
+	
+	return true;
+}
+
+// Pairs of a class are consecutive, in level order.
+quint64 HexClassIndex::Key(quint32 id, quint32 level)
+{
+	return (static_cast<quint64>(id) << 32) | level;
+}
+
+// A query that does not read, or names an unknown class, matches nothing.
+HexBitmap HexClassIndex::match(const QString& query) const
+{
+	auto result = HexBitmap(HexClassIndex::records, true);
+	
+	for (const auto& text : query.split(',', Qt::SkipEmptyParts))
+	{
+		auto term = Term();
+		
+		if (not HexClassIndex::Parse(text, term) or not HexClassIndex::classes.contains(term.name))
+			return HexBitmap(HexClassIndex::records, false);
+		
+		const auto id = HexClassIndex::classes.value(term.name);
+		const auto from = std::lower_bound(HexClassIndex::keys.cbegin(), HexClassIndex::keys.cend(), HexClassIndex::Key(id, term.low));
+		const auto to = std::upper_bound(from, HexClassIndex::keys.cend(), HexClassIndex::Key(id, term.high));
+		
+		auto matches = HexBitmap(HexClassIndex::records, false);
+		
+		for (auto it = from; it != to; ++it)
+		{
+			const auto k = static_cast<std::size_t>(it - HexClassIndex::keys.cbegin());
+			
+			for (auto i = HexClassIndex::starts[k]; i < HexClassIndex::starts[k + 1u]; ++i)
+				matches.setBit(HexClassIndex::postings[i]);
+		}
+		
+		result.intersect(matches);
+	}
+	
+	return result;
+}
+
+// The class is everything before the first digit or comparison sign, lowered; the rest gives the levels.
+bool HexClassIndex::Parse(QStringView text, Term& term)
+{
+	auto split = qsizetype(0);
+	
+	while (split < text.size() and not text[split].isDigit() and not QStringView(u"<>=≤≥").contains(text[split]))
+		++split;
+	
+	term.name = text.first(split).trimmed().toString().toLower();
+	
+	if (term.name.isEmpty())
+		return false;
+	
+	const auto levels = text.sliced(split).trimmed();
+	auto bound = 0u;
+	
+	if (levels.isEmpty())
+	{
+		term.low = 0u;
+		term.high = std::numeric_limits<quint32>::max();
+		return true;
+	}
+	
+	if (levels.startsWith(u"<=") or levels.startsWith(u"≤") or levels.startsWith(u">=") or levels.startsWith(u"≥"))
+	{
+		if (not HexClassIndex::ParseBound(levels.sliced(levels[0].unicode() > 0xFFu ? 1 : 2), bound))
+			return false;
+		
+		const auto below = (levels[0] == '<' or levels[0] == QChar(u'≤'));
+		term.low = (below ? 0u : bound);
+		term.high = (below ? bound : std::numeric_limits<quint32>::max());
+		return true;
+	}
+	
+	if (levels.startsWith(u"<") or levels.startsWith(u">"))
+	{
+		if (not HexClassIndex::ParseBound(levels.sliced(1), bound) or (levels[0] == '<' and bound == 0u))
+			return false;
+		
+		term.low = (levels[0] == '<' ? 0u : bound + 1u);
+		term.high = (levels[0] == '<' ? bound - 1u : std::numeric_limits<quint32>::max());
+		return true;
+	}
+	
+	const auto range = levels.indexOf(u"..");
+	const auto dash = levels.indexOf(u'-');
+	
+	if (range >= 0 or dash >= 0)
+	{
+		const auto cut = (range >= 0 ? range : dash);
+		auto high = 0u;
+		
+		if (not HexClassIndex::ParseBound(levels.first(cut), bound) or not HexClassIndex::ParseBound(levels.sliced(cut + (range >= 0 ? 2 : 1)), high) or high < bound)
+			return false;
+		
+		term.low = bound;
+		term.high = high;
+		return true;
+	}
+	
+	if (not HexClassIndex::ParseBound(levels.startsWith(u"=") ? levels.sliced(1) : levels, bound))
+		return false;
+	
+	term.low = bound;
+	term.high = bound;
+	return true;
+}
+
+bool HexClassIndex::ParseBound(QStringView text, quint32& bound)
+{
+	auto ok = false;
+	bound = text.trimmed().toUInt(&ok);
+	
+	return ok;
+}
+
+#endif
@@ -0,0 +1,570 @@
+#ifndef __HEX_DATABASE_HPP__
+#define __HEX_DATABASE_HPP__
+
+// C++ Libraries
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// Qt Libraries
+#include <QByteArray>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+#include <QSaveFile>
+#include <QString>
+#include <QtGlobal>
+
+// Custom Libraries
+#include "HexBitmapIndex.hpp"
+#include "HexClassIndex.hpp"
+#include "HexFile.hpp"
+#include "HexLoreIndex.hpp"
+#include "HexLoreStore.hpp"
+#include "HexMatcher.hpp"
+#include "HexNameIndex.hpp"
+#include "HexSuffixIndex.hpp"
+#include "HexTopK.hpp"
+#include "HexTextParser.hpp"
+
+// Layout of a compiled database (native byte order, every section aligned on 64 bytes):
+// header, bitset words (records x words), record table, name table (UTF-16), name index (record indices sorted by name).
+struct HexDatabaseHeader
+{
+	static constexpr char		Magic[8] = { 'H', 'E', 'X', 'D', 'B', '\0', '\0', '\0' };
+	static constexpr quint32	Version = 1u;
+	
+	char				magic[8];
+	quint32				version;
+	quint32				number;
+	quint32				words;
+	quint32				records;
+	quint32				names;
+	quint32				reserved;
+	quint64				sourceSize;
+	qint64				sourceModified;
+	quint64				bitsOffset;
+	quint64				recordsOffset;
+	quint64				nameTableOffset;
+	quint64				nameTableSize;
+	quint64				nameIndexOffset;
+	quint64				fileSize;
+};
+
+struct HexDatabaseRecord
+{
+	quint32				nameOffset;
+	quint32				nameLength;
+	qint32				infoPositionInFile;
+	qint32				textPositionInFile;
+};
+
+template<quint32 Number>
+class HexDatabase
+{
+	private:
+	
+		static constexpr quint64			Alignment = 64llu;
+		static constexpr qsizetype			DefaultLoreBudget = 256ll << 20;
+		static constexpr double				NameBoost = 2.0;
+		
+		inline static quint64				Align(quint64);
+		inline static QByteArrayView			InfoField(QByteArrayView, qint32);
+		inline static qsizetype				LoreBudget(void);
+		inline static QByteArrayView			LoreLine(QByteArrayView, qint32);
+		inline static bool				SuffixEngine(void);
+		
+		const QString					textPath;
+		const QString					compiledPath;
+		
+		// Fields of the info holding "class level" lists, first to last, which depend on the file.
+		const qsizetype					classFieldFirst;
+		const qsizetype					classFieldLast;
+		
+		QFile						compiledFile;
+		QFile						textFile;
+		QByteArray					textBuffer;
+		QByteArrayView					text;
+		std::vector<HexFile<Number>>			files;
+		QMap<QString, quint32>				nameToIndex;
+		quint32						mismatches = 0u;
+		quint32						generation = 0u;
+		HexLoreStore					lore;
+		HexClassIndex					classIndex;
+		HexLoreIndex					loreIndex;
+		HexSuffixIndex					suffixIndex;
+		HexBitmapIndex<Number>				bitmapIndex;
+		HexNameIndex<Number>				nameIndex;
+		
+		inline bool					isFresh(const HexDatabaseHeader&, qint64) const;
+		inline bool					loadLore(void);
+	
+	public:
+	
+		inline						HexDatabase(const QString&, const QString&, qsizetype, qsizetype);
+		
+		inline bool					compile(void) const;
+		inline bool					containsLore(quint32, const QString&) const;
+		inline const HexClassIndex&			getClassIndex(void) const;
+		inline const std::vector<HexFile<Number>>&	getFiles(void) const;
+		inline quint32					getGeneration(void) const;
+		inline QString					getInfo(quint32) const;
+		inline const HexBitmapIndex<Number>&		getIndex(void) const;
+		inline const HexLoreStore&			getLore(void) const;
+		inline const HexLoreIndex&			getLoreIndex(void) const;
+		inline QString					getLoreLine(quint32) const;
+		inline quint32					getMismatches(void) const;
+		inline const HexNameIndex<Number>&		getNameIndex(void) const;
+		inline const QMap<QString, quint32>&		getNameToIndex(void) const;
+		inline bool					indexesLore(bool) const;
+		inline bool					load(void);
+		inline bool					loadCompiled(void);
+		inline bool					loadText(void);
+		inline HexBitmap				matchLore(const QString&, bool) const;
+		inline std::vector<std::pair<double, quint32>>	rank(const QString&, const HexBitmap&, std::size_t) const;
+};
+
+template<quint32 Number>
+HexDatabase<Number>::HexDatabase(const QString& text, const QString& compiled, qsizetype first, qsizetype last) : textPath(text), compiledPath(compiled), classFieldFirst(first), classFieldLast(last), compiledFile(compiled), textFile(text)
+{
+}
+
+template<quint32 Number>
+quint64 HexDatabase<Number>::Align(quint64 offset)
+{
+	return (offset + HexDatabase::Alignment - 1llu)/HexDatabase::Alignment*HexDatabase::Alignment;
+}
+
+template<quint32 Number>
+bool HexDatabase<Number>::compile(void) const
+{
+	const auto source = QFileInfo(HexDatabase::textPath);
+	const auto words = HexBitset<Number>::ARRAY_SIZE;
+	
+	auto nameTable = QString();
+	auto records = std::vector<HexDatabaseRecord>();
+	records.reserve(HexDatabase::files.size());
+	
+	for (const auto& file : HexDatabase::files)
+	{
+		records.push_back({ static_cast<quint32>(nameTable.size()), static_cast<quint32>(file.name.size()), file.infoPositionInFile, file.textPositionInFile });
+		nameTable += file.name;
+	}
+	
+	auto header = HexDatabaseHeader();
+	std::memcpy(header.magic, HexDatabaseHeader::Magic, sizeof(header.magic));
+	
+	header.version = HexDatabaseHeader::Version;
+	header.number = Number;
+	header.words = static_cast<quint32>(words);
+	header.records = static_cast<quint32>(HexDatabase::files.size());
+	header.names = static_cast<quint32>(HexDatabase::nameToIndex.size());
+	header.sourceSize = static_cast<quint64>(source.size());
+	header.sourceModified = source.lastModified().toMSecsSinceEpoch();
+	
+	header.bitsOffset = HexDatabase::Align(sizeof(HexDatabaseHeader));
+	header.recordsOffset = HexDatabase::Align(header.bitsOffset + header.records*words*sizeof(quint64));
+	header.nameTableOffset = HexDatabase::Align(header.recordsOffset + header.records*sizeof(HexDatabaseRecord));
+	header.nameTableSize = static_cast<quint64>(nameTable.size());
+	header.nameIndexOffset = HexDatabase::Align(header.nameTableOffset + header.nameTableSize*sizeof(QChar));
+	header.fileSize = header.nameIndexOffset + header.names*sizeof(quint32);
+	
+	auto buffer = QByteArray(static_cast<qsizetype>(header.fileSize), '\0');
+	const auto base = buffer.data();
+	
+	std::memcpy(base, &header, sizeof(HexDatabaseHeader));
+	
+	for (auto i = 0llu; i < header.records; ++i)
+		std::memcpy(base + header.bitsOffset + i*words*sizeof(quint64), HexDatabase::files[i].bits.data(), words*sizeof(quint64));
+	
+	std::memcpy(base + header.recordsOffset, records.data(), records.size()*sizeof(HexDatabaseRecord));
+	std::memcpy(base + header.nameTableOffset, nameTable.constData(), header.nameTableSize*sizeof(QChar));
+	
+	auto nameIndex = reinterpret_cast<quint32*>(base + header.nameIndexOffset);
+	
+	for (const auto index : HexDatabase::nameToIndex)
+		*(nameIndex++) = index;
+	
+	auto output = QSaveFile(HexDatabase::compiledPath);
+	
+	if (not output.open(QIODevice::WriteOnly))
+		return false;
+	
+	if (output.write(buffer) != buffer.size())
+	{
+		output.cancelWriting();
+		return false;
+	}
+	
+	return output.commit();
+}
+
+// Both tests take a lowered pattern and only read the database, so any number of threads may call them at once.
+template<quint32 Number>
+bool HexDatabase<Number>::containsLore(quint32 index, const QString& pattern) const
+{
+	if (HexDatabase::lore.isResident())
+		return HexMatcher::Contains(HexDatabase::lore.at(index), pattern);
+	
+	const auto line = HexDatabase::LoreLine(HexDatabase::text, HexDatabase::files[index].textPositionInFile);
+	return HexMatcher::Contains(QString::fromUtf8(line), pattern);
+}
+
+template<quint32 Number>
+const HexClassIndex& HexDatabase<Number>::getClassIndex(void) const
+{
+	return HexDatabase::classIndex;
+}
+
+template<quint32 Number>
+const std::vector<HexFile<Number>>& HexDatabase<Number>::getFiles(void) const
+{
+	return HexDatabase::files;
+}
+
+template<quint32 Number>
+quint32 HexDatabase<Number>::getGeneration(void) const
+{
+	return HexDatabase::generation;
+}
+
+// The fields of a record before its description, as written, read from the text kept since the load.
+template<quint32 Number>
+QString HexDatabase<Number>::getInfo(quint32 index) const
+{
+	return QString::fromUtf8(HexDatabase::InfoField(HexDatabase::text, HexDatabase::files[index].infoPositionInFile));
+}
+
+template<quint32 Number>
+const HexBitmapIndex<Number>& HexDatabase<Number>::getIndex(void) const
+{
+	return HexDatabase::bitmapIndex;
+}
+
+template<quint32 Number>
+const HexLoreStore& HexDatabase<Number>::getLore(void) const
+{
+	return HexDatabase::lore;
+}
+
+template<quint32 Number>
+const HexLoreIndex& HexDatabase<Number>::getLoreIndex(void) const
+{
+	return HexDatabase::loreIndex;
+}
+
+// The description of a record as written: the lore store keeps it lowered, for searches.
+template<quint32 Number>
+QString HexDatabase<Number>::getLoreLine(quint32 index) const
+{
+	return QString::fromUtf8(HexDatabase::LoreLine(HexDatabase::text, HexDatabase::files[index].textPositionInFile));
+}
+
+template<quint32 Number>
+quint32 HexDatabase<Number>::getMismatches(void) const
+{
+	return HexDatabase::mismatches;
+}
+
+template<quint32 Number>
+const HexNameIndex<Number>& HexDatabase<Number>::getNameIndex(void) const
+{
+	return HexDatabase::nameIndex;
+}
+
+template<quint32 Number>
+const QMap<QString, quint32>& HexDatabase<Number>::getNameToIndex(void) const
+{
+	return HexDatabase::nameToIndex;
+}
+
+template<quint32 Number>
+qsizetype HexDatabase<Number>::LoreBudget(void)
+{
+	auto ok = false;
+	const auto megabytes = qEnvironmentVariableIntValue("DND_LORE_BUDGET", &ok);
+	
+	return (ok ? static_cast<qsizetype>(megabytes) << 20 : HexDatabase::DefaultLoreBudget);
+}
+
+// The info of a record runs from its position to the next '@'.
+template<quint32 Number>
+QByteArrayView HexDatabase<Number>::InfoField(QByteArrayView text, qint32 position)
+{
+	const auto start = text.data() + std::clamp<qsizetype>(position, 0, text.size());
+	const auto end = static_cast<const char*>(std::memchr(start, '@', static_cast<size_t>(text.data() + text.size() - start)));
+	
+	return QByteArrayView(start, (end == nullptr ? text.data() + text.size() : end));
+}
+
+template<quint32 Number>
+QByteArrayView HexDatabase<Number>::LoreLine(QByteArrayView text, qint32 position)
+{
+	const auto start = text.data() + std::clamp<qsizetype>(position, 0, text.size());
+	const auto newline = static_cast<const char*>(std::memchr(start, '\n', static_cast<size_t>(text.data() + text.size() - start)));
+	
+	auto line = QByteArrayView(start, (newline == nullptr ? text.data() + text.size() : newline));
+	
+	if (not line.isEmpty() and line.back() == '\r')
+		line = line.chopped(1);
+	
+	return line;
+}
+
+// Whether matchLore can answer a lore search of this kind, instead of testing records one at a time.
+template<quint32 Number>
+bool HexDatabase<Number>::indexesLore(bool wordSearch) const
+{
+	return (wordSearch or HexDatabase::suffixIndex.isBuilt());
+}
+
+template<quint32 Number>
+bool HexDatabase<Number>::isFresh(const HexDatabaseHeader& header, qint64 size) const
+{
+	if (std::memcmp(header.magic, HexDatabaseHeader::Magic, sizeof(header.magic)) != 0)
+		return false;
+	
+	if (header.version != HexDatabaseHeader::Version or header.number != Number or header.words != HexBitset<Number>::ARRAY_SIZE)
+		return false;
+	
+	if (header.fileSize != static_cast<quint64>(size))
+		return false;
+	
+	if (header.bitsOffset + header.records*header.words*sizeof(quint64) > header.recordsOffset)
+		return false;
+	
+	if (header.recordsOffset + header.records*sizeof(HexDatabaseRecord) > header.nameTableOffset)
+		return false;
+	
+	if (header.nameTableOffset + header.nameTableSize*sizeof(QChar) > header.nameIndexOffset)
+		return false;
+	
+	if (header.nameIndexOffset + header.names*sizeof(quint32) > header.fileSize)
+		return false;
+	
+	const auto source = QFileInfo(HexDatabase::textPath);
+	
+	return (header.sourceSize == static_cast<quint64>(source.size()) and header.sourceModified == source.lastModified().toMSecsSinceEpoch());
+}
+
+template<quint32 Number>
+bool HexDatabase<Number>::load(void)
+{
+	if (not HexDatabase::loadCompiled() and not HexDatabase::loadText())
+		return false;
+	
+	// Anything derived from the previous records, such as cached results, compares generations to know it is stale.
+	HexDatabase::bitmapIndex.build(HexDatabase::files);
+	HexDatabase::nameIndex.build(HexDatabase::files);
+	++HexDatabase::generation;
+	
+	return HexDatabase::loadLore();
+}
+
+template<quint32 Number>
+bool HexDatabase<Number>::loadCompiled(void)
+{
+	if (not HexDatabase::compiledFile.open(QIODevice::ReadOnly))
+		return false;
+	
+	const auto size = HexDatabase::compiledFile.size();
+	const auto base = (size >= static_cast<qint64>(sizeof(HexDatabaseHeader)) ? HexDatabase::compiledFile.map(0, size) : nullptr);
+	
+	if (base == nullptr)
+	{
+		HexDatabase::compiledFile.close();
+		return false;
+	}
+	
+	// Nothing of a rejected file is kept, since the text is loaded instead.
+	const auto reject = [this, base](void)
+	{
+		HexDatabase::files.clear();
+		HexDatabase::nameToIndex.clear();
+		HexDatabase::compiledFile.unmap(base);
+		HexDatabase::compiledFile.close();
+		return false;
+	};
+	
+	const auto& header = *reinterpret_cast<const HexDatabaseHeader*>(base);
+	
+	if (not HexDatabase::isFresh(header, size))
+	{
+		std::cerr << "Ignoring stale or invalid compiled database " << HexDatabase::compiledPath.toStdString() << "." << std::endl;
+		return reject();
+	}
+	
+	const auto bits = reinterpret_cast<const quint64*>(base + header.bitsOffset);
+	const auto records = reinterpret_cast<const HexDatabaseRecord*>(base + header.recordsOffset);
+	const auto nameTable = reinterpret_cast<const QChar*>(base + header.nameTableOffset);
+	const auto nameIndex = reinterpret_cast<const quint32*>(base + header.nameIndexOffset);
+	
+	HexDatabase::files.clear();
+	HexDatabase::files.reserve(header.records);
+	HexDatabase::nameToIndex.clear();
+	
+	for (auto i = 0u; i < header.records; ++i)
+	{
+		const auto& record = records[i];
+		
+		if (static_cast<quint64>(record.nameOffset) + record.nameLength > header.nameTableSize)
+			return reject();
+		
+		// The names point straight into the mapping, which lives as long as this database.
+		const auto name = QString::fromRawData(nameTable + record.nameOffset, record.nameLength);
+		HexDatabase::files.emplace_back(name, HexBitset<Number>(bits + i*header.words), record.infoPositionInFile, record.textPositionInFile);
+	}
+	
+	for (auto i = 0u; i < header.names; ++i)
+	{
+		const auto index = nameIndex[i];
+		
+		if (index >= header.records)
+			return reject();
+		
+		// Entries are stored in key order, so every insertion lands at the end of the map.
+		HexDatabase::nameToIndex.insert(HexDatabase::nameToIndex.cend(), HexDatabase::files[index].name, index);
+	}
+	
+	return true;
+}
+
+template<quint32 Number>
+bool HexDatabase<Number>::loadLore(void)
+{
+	HexDatabase::lore.clear();
+	HexDatabase::text = QByteArrayView();
+	HexDatabase::textBuffer.clear();
+	HexDatabase::textFile.close();
+	
+	if (not HexDatabase::textFile.open(QIODevice::ReadOnly))
+		return false;
+	
+	// The text stays mapped for the lifetime of the database, so the lore of any record can be read without a shared stream.
+	const auto size = HexDatabase::textFile.size();
+	const auto mapping = (size > 0 ? HexDatabase::textFile.map(0, size) : nullptr);
+	
+	if (mapping == nullptr)
+		HexDatabase::textBuffer = HexDatabase::textFile.readAll();
+	
+	HexDatabase::text = (mapping == nullptr ? QByteArrayView(HexDatabase::textBuffer) : QByteArrayView(mapping, size));
+	
+	// Decoded and lowered, the lore takes at most two bytes per byte of text. Past the budget it is decoded on demand.
+	if (2*size <= HexDatabase::LoreBudget())
+	{
+		HexDatabase::lore.reserve(HexDatabase::text.size(), static_cast<qsizetype>(HexDatabase::files.size()));
+		
+		for (const auto& file : HexDatabase::files)
+			HexDatabase::lore.append(HexDatabase::LoreLine(HexDatabase::text, file.textPositionInFile));
+		
+		HexDatabase::lore.squeeze();
+	}
+	
+	if (HexDatabase::SuffixEngine())
+	{
+		if (HexDatabase::lore.isResident())
+		{
+			auto timer = QElapsedTimer();
+			timer.start();
+			
+			HexDatabase::suffixIndex.build(HexDatabase::lore.getCorpus(), HexDatabase::lore.getOffsets());
+			std::cout << HexDatabase::textPath.toStdString() << ": suffix array over " << HexDatabase::lore.getCorpus().size() << " characters built in " << timer.elapsed() << " ms, " << (HexDatabase::suffixIndex.memory() >> 20) << " MiB." << std::endl;
+		}
+		else
+			std::cerr << HexDatabase::textPath.toStdString() << ": the lore is over budget, searching it without the suffix array." << std::endl;
+	}
+	
+	// The word index is small enough to be kept whatever the budget.
+	HexDatabase::loreIndex.build(static_cast<quint32>(HexDatabase::files.size()), [this](quint32 index)
+	{
+		if (HexDatabase::lore.isResident())
+			return HexDatabase::lore.at(index).toString();
+		
+		return QString::fromUtf8(HexDatabase::LoreLine(HexDatabase::text, HexDatabase::files[index].textPositionInFile)).toLower();
+	});
+	
+	HexDatabase::classIndex.build(static_cast<quint32>(HexDatabase::files.size()), HexDatabase::classFieldFirst, HexDatabase::classFieldLast, [this](quint32 index)
+	{
+		return QString::fromUtf8(HexDatabase::InfoField(HexDatabase::text, HexDatabase::files[index].infoPositionInFile));
+	});
+	
+	return true;
+}
+
+template<quint32 Number>
+bool HexDatabase<Number>::loadText(void)
+{
+	auto textFile = QFile(HexDatabase::textPath);
+	
+	if (not textFile.open(QIODevice::ReadOnly))
+		return false;
+	
+	const auto size = textFile.size();
+	const auto mapping = (size > 0 ? textFile.map(0, size) : nullptr);
+	const auto buffer = (mapping == nullptr ? textFile.readAll() : QByteArray());
+	const auto text = (mapping == nullptr ? QByteArrayView(buffer) : QByteArrayView(mapping, size));
+	
+	HexDatabase::files.clear();
+	HexDatabase::nameToIndex.clear();
+	HexDatabase::mismatches = 0u;
+	
+	auto parser = HexTextParser(text);
+	auto line = 0u;
+	
+	while (not parser.atEnd())
+	{
+		const auto record = parser.next();
+		const auto name = QString::fromUtf8(record.name);
+		
+		if (record.bits.size() != static_cast<qsizetype>(Number))
+		{
+			std::cerr << HexDatabase::textPath.toStdString() << ":" << line + 1u << ": " << name.toStdString() << " has " << record.bits.size() << " flags, " << Number << " expected." << std::endl;
+			++HexDatabase::mismatches;
+		}
+		
+		HexDatabase::files.emplace_back(name, HexBitset<Number>(record.bits), record.infoPositionInFile, record.textPositionInFile);
+		HexDatabase::nameToIndex[name] = line++;
+	}
+	
+	return true;
+}
+
+// The pattern is lowered; a word search goes to the word index, anything else to the suffix array.
+template<quint32 Number>
+HexBitmap HexDatabase<Number>::matchLore(const QString& pattern, bool wordSearch) const
+{
+	return (wordSearch ? HexDatabase::loreIndex.match(pattern) : HexDatabase::suffixIndex.match(pattern));
+}
+
+// The best count records of a result for a lowered lore query, best first: BM25 over the descriptions, plus, for every query word that is a whole word of the name, twice its weight.
+template<quint32 Number>
+std::vector<std::pair<double, quint32>> HexDatabase<Number>::rank(const QString& pattern, const HexBitmap& result, std::size_t count) const
+{
+	auto scores = HexDatabase::loreIndex.score(pattern, result);
+	
+	for (const auto& [word, weight] : HexDatabase::loreIndex.weights(pattern))
+	{
+		result.forEach([this, &scores, &word, weight](quint32 index)
+		{
+			if (HexDatabase::nameIndex.containsWord(index, word))
+				scores[index] += HexDatabase::NameBoost*weight;
+		});
+	}
+	
+	auto best = HexTopK(count);
+	result.forEach([&scores, &best](quint32 index) { best.push(scores[index], index); });
+	
+	return best.take();
+}
+
+// DND_LORE_ENGINE=suffix replaces the lore scan with a suffix array, built at load.
+template<quint32 Number>
+bool HexDatabase<Number>::SuffixEngine(void)
+{
+	return (qEnvironmentVariable("DND_LORE_ENGINE") == "suffix");
+}
+
+#endif
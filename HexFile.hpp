@@ -0,0 +1,28 @@
+#ifndef __HEX_FILE_HPP__
+#define __HEX_FILE_HPP__
+
+// Qt Libraries
+#include <QString>
+
+// Custom Libraries
+#include "HexBitset.hpp"
+
+template<quint32 Number>
+struct HexFile
+{
+	QString			name = "";
+	HexBitset<Number>	bits;
+	
+	qint32			infoPositionInFile = -1;
+	qint32			textPositionInFile = -1;
+	
+	HexFile(const QString& n, const QString& b, qint32 ip, qint32 tp) : name(n), bits(b), infoPositionInFile(ip), textPositionInFile(tp)
+	{
+	}
+	
+	HexFile(const QString& n, const HexBitset<Number>& b, qint32 ip, qint32 tp) : name(n), bits(b), infoPositionInFile(ip), textPositionInFile(tp)
+	{
+	}
+};
+
+#endif
@@ -0,0 +1,428 @@
+#ifndef __HEX_LORE_INDEX_HPP__
+#define __HEX_LORE_INDEX_HPP__
+
+// C++ Libraries
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+// Qt Libraries
+#include <QHash>
+#include <QString>
+#include <QStringView>
+
+// Custom Libraries
+#include "HexBitmap.hpp"
+
+// Inverted index over the words of every description, with the position of each occurrence.
+// Words are runs of letters and digits, so the markup ({, }, [, ], |, #, *, $) and the punctuation only separate them; the kind of a link, a digit from 1 to 5 after '[', is skipped as it is never shown.
+// A query is a list of words and "quoted phrases", all required unless joined by OR; NOT or a leading - excludes the next term, and parentheses group.
+// The length of every description is kept as well, for BM25 scores.
+class HexLoreIndex
+{
+	private:
+	
+		struct Postings
+		{
+			std::vector<quint32>		records;
+			std::vector<quint32>		starts;
+			std::vector<quint32>		positions;
+		};
+		
+		enum class Symbol
+		{
+			Term,
+			And,
+			Or,
+			Not,
+			Open,
+			Close
+		};
+		
+		struct Token
+		{
+			Symbol				symbol;
+			std::vector<QString>		words;
+		};
+		
+		inline static std::vector<Token>	Lex(const QString&);
+		
+		static constexpr double			K1 = 1.2;
+		static constexpr double			B = 0.75;
+		
+		QHash<QString, quint32>			dictionary;
+		std::vector<Postings>			postings;
+		std::vector<quint32>			lengths;
+		double					averageLength = 0.0;
+		quint32					records = 0u;
+		
+		inline HexBitmap			evaluateAnd(const std::vector<Token>&, std::size_t&) const;
+		inline HexBitmap			evaluateOr(const std::vector<Token>&, std::size_t&) const;
+		inline HexBitmap			evaluateUnary(const std::vector<Token>&, std::size_t&) const;
+		inline double				inverseFrequency(const Postings&) const;
+		inline HexBitmap			phrase(const std::vector<QString>&) const;
+	
+	public:
+	
+		template<typename Function> inline static void	Tokenise(QStringView, Function);
+		
+		template<typename Function> inline void	build(quint32, Function);
+		inline HexBitmap			match(const QString&) const;
+		inline std::vector<double>		score(const QString&, const HexBitmap&) const;
+		inline std::vector<std::pair<QString, double>>	weights(const QString&) const;
+};
+
+template<typename Function>
+void HexLoreIndex::Tokenise(QStringView text, Function function)
+{
+	auto position = 0u;
+	auto start = qsizetype(-1);
+	auto hidden = qsizetype(-1);
+	
+	for (qsizetype i = 0; i <= text.size(); ++i)
+	{
+		// As in QAbstractDatabaseWindow::Process, so that "[1Plane Shifts]" gives "plane" and "shifts".
+		if (i + 1 < text.size() and text[i] == '[' and text[i + 1].unicode() >= '1' and text[i + 1].unicode() <= '5')
+			hidden = i + 1;
+		
+		const auto inside = (i < text.size() and i != hidden and text[i].isLetterOrNumber());
+		
+		if (inside and start < 0)
+			start = i;
+		else if (not inside and start >= 0)
+		{
+			function(text.sliced(start, i - start), position++);
+			start = -1;
+		}
+	}
+}
+
+// Splits a lowered query into terms and operators. A quoted phrase, or a word the tokeniser cuts in several, is one term.
+std::vector<HexLoreIndex::Token> HexLoreIndex::Lex(const QString& query)
+{
+	auto result = std::vector<Token>();
+	auto i = qsizetype(0);
+	
+	const auto addTerm = [&result](QStringView text)
+	{
+		auto words = std::vector<QString>();
+		HexLoreIndex::Tokenise(text, [&words](QStringView word, quint32) { words.push_back(word.toString()); });
+		
+		if (not words.empty())
+			result.push_back({ Symbol::Term, std::move(words) });
+	};
+	
+	while (i < query.size())
+	{
+		const auto c = query[i];
+		
+		if (c.isSpace())
+			++i;
+		else if (c == '(' or c == ')')
+		{
+			result.push_back({ (c == '(' ? Symbol::Open : Symbol::Close), {} });
+			++i;
+		}
+		else if (c == '-')
+		{
+			result.push_back({ Symbol::Not, {} });
+			++i;
+		}
+		else if (c == '"')
+		{
+			const auto end = query.indexOf('"', i + 1);
+			const auto stop = (end < 0 ? query.size() : end);
+			
+			addTerm(QStringView(query).sliced(i + 1, stop - i - 1));
+			i = stop + 1;
+		}
+		else
+		{
+			auto end = i;
+			
+			while (end < query.size() and not query[end].isSpace() and query[end] != '(' and query[end] != ')' and query[end] != '"')
+				++end;
+			
+			const auto word = QStringView(query).sliced(i, end - i);
+			
+			if (word == u"or")
+				result.push_back({ Symbol::Or, {} });
+			else if (word == u"and")
+				result.push_back({ Symbol::And, {} });
+			else if (word == u"not")
+				result.push_back({ Symbol::Not, {} });
+			else
+				addTerm(word);
+			
+			i = end;
+		}
+	}
+	
+	return result;
+}
+
+// The function gives the lowered description of a record.
+template<typename Function>
+void HexLoreIndex::build(quint32 count, Function loreOf)
+{
+	HexLoreIndex::dictionary.clear();
+	HexLoreIndex::postings.clear();
+	HexLoreIndex::lengths.assign(count, 0u);
+	HexLoreIndex::records = count;
+	
+	auto total = 0.0;
+	
+	for (auto record = 0u; record < count; ++record)
+	{
+		const auto lore = loreOf(record);
+		
+		HexLoreIndex::Tokenise(lore, [this, record](QStringView word, quint32 position)
+		{
+			++HexLoreIndex::lengths[record];
+			
+			const auto it = HexLoreIndex::dictionary.constFind(word.toString());
+			auto term = static_cast<quint32>(HexLoreIndex::postings.size());
+			
+			if (HexLoreIndex::dictionary.cend() == it)
+			{
+				HexLoreIndex::dictionary.insert(word.toString(), term);
+				HexLoreIndex::postings.emplace_back();
+			}
+			else
+				term = it.value();
+			
+			auto& list = HexLoreIndex::postings[term];
+			
+			if (list.records.empty() or list.records.back() != record)
+			{
+				list.records.push_back(record);
+				list.starts.push_back(static_cast<quint32>(list.positions.size()));
+			}
+			
+			list.positions.push_back(position);
+		});
+		
+		total += HexLoreIndex::lengths[record];
+	}
+	
+	HexLoreIndex::averageLength = (count == 0u ? 0.0 : total/count);
+	
+	for (auto& list : HexLoreIndex::postings)
+	{
+		list.starts.push_back(static_cast<quint32>(list.positions.size()));
+		
+		list.records.shrink_to_fit();
+		list.starts.shrink_to_fit();
+		list.positions.shrink_to_fit();
+	}
+}
+
+HexBitmap HexLoreIndex::evaluateAnd(const std::vector<Token>& tokens, std::size_t& k) const
+{
+	auto result = HexLoreIndex::evaluateUnary(tokens, k);
+	
+	while (k < tokens.size() and tokens[k].symbol != Symbol::Or and tokens[k].symbol != Symbol::Close)
+	{
+		if (tokens[k].symbol == Symbol::And)
+			++k;
+		
+		result.intersect(HexLoreIndex::evaluateUnary(tokens, k));
+	}
+	
+	return result;
+}
+
+HexBitmap HexLoreIndex::evaluateOr(const std::vector<Token>& tokens, std::size_t& k) const
+{
+	auto result = HexLoreIndex::evaluateAnd(tokens, k);
+	
+	while (k < tokens.size() and tokens[k].symbol == Symbol::Or)
+	{
+		++k;
+		result.unite(HexLoreIndex::evaluateAnd(tokens, k));
+	}
+	
+	return result;
+}
+
+// A dangling operator matches everything, so a query being typed never empties the list on its own.
+HexBitmap HexLoreIndex::evaluateUnary(const std::vector<Token>& tokens, std::size_t& k) const
+{
+	if (k >= tokens.size())
+		return HexBitmap(HexLoreIndex::records, true);
+	
+	const auto& token = tokens[k++];
+	
+	switch (token.symbol)
+	{
+		case Symbol::Term:
+			return HexLoreIndex::phrase(token.words);
+		
+		case Symbol::Not:
+		{
+			if (k >= tokens.size())
+				return HexBitmap(HexLoreIndex::records, true);
+			
+			auto result = HexBitmap(HexLoreIndex::records, true);
+			result.subtract(HexLoreIndex::evaluateUnary(tokens, k));
+			return result;
+		}
+		
+		case Symbol::Open:
+		{
+			auto result = HexLoreIndex::evaluateOr(tokens, k);
+			
+			if (k < tokens.size() and tokens[k].symbol == Symbol::Close)
+				++k;
+			
+			return result;
+		}
+		
+		default:
+			return HexBitmap(HexLoreIndex::records, true);
+	}
+}
+
+double HexLoreIndex::inverseFrequency(const Postings& list) const
+{
+	const auto n = static_cast<double>(list.records.size());
+	return std::log(1.0 + (HexLoreIndex::records - n + 0.5)/(n + 0.5));
+}
+
+// Records matching a lowered query.
+HexBitmap HexLoreIndex::match(const QString& query) const
+{
+	const auto tokens = HexLoreIndex::Lex(query);
+	auto k = std::size_t(0u);
+	auto result = HexLoreIndex::evaluateOr(tokens, k);
+	
+	// Unbalanced closing parentheses are skipped.
+	while (k < tokens.size())
+	{
+		++k;
+		result.intersect(HexLoreIndex::evaluateOr(tokens, k));
+	}
+	
+	return result;
+}
+
+// Records where the words appear one after the other. The records of the rarest word are the only candidates.
+HexBitmap HexLoreIndex::phrase(const std::vector<QString>& words) const
+{
+	auto result = HexBitmap(HexLoreIndex::records, false);
+	auto lists = std::vector<const Postings*>();
+	
+	for (const auto& word : words)
+	{
+		const auto it = HexLoreIndex::dictionary.constFind(word);
+		
+		if (HexLoreIndex::dictionary.cend() == it)
+			return result;
+		
+		lists.push_back(&HexLoreIndex::postings[it.value()]);
+	}
+	
+	auto rarest = std::size_t(0u);
+	
+	for (auto i = std::size_t(1u); i < lists.size(); ++i)
+	{
+		if (lists[i]->records.size() < lists[rarest]->records.size())
+			rarest = i;
+	}
+	
+	for (const auto record : lists[rarest]->records)
+	{
+		// Where every word sits in this record, or nothing if one of them is absent.
+		auto spans = std::vector<std::pair<const quint32*, const quint32*>>();
+		
+		for (const auto list : lists)
+		{
+			const auto it = std::lower_bound(list->records.cbegin(), list->records.cend(), record);
+			
+			if (list->records.cend() == it or *it != record)
+				break;
+			
+			const auto k = static_cast<std::size_t>(it - list->records.cbegin());
+			spans.emplace_back(list->positions.data() + list->starts[k], list->positions.data() + list->starts[k + 1u]);
+		}
+		
+		if (spans.size() != lists.size())
+			continue;
+		
+		for (auto first = spans[0].first; first != spans[0].second; ++first)
+		{
+			auto found = true;
+			
+			for (auto i = std::size_t(1u); i < spans.size() and found; ++i)
+				found = std::binary_search(spans[i].first, spans[i].second, *first + static_cast<quint32>(i));
+			
+			if (found)
+			{
+				result.setBit(record);
+				break;
+			}
+		}
+	}
+	
+	return result;
+}
+
+// BM25 of every candidate for the words of a lowered query, indexed by record; the others stay at zero.
+// Only the postings of the query words are read, so the cost follows how common they are, not the number of records.
+std::vector<double> HexLoreIndex::score(const QString& query, const HexBitmap& candidates) const
+{
+	auto result = std::vector<double>(HexLoreIndex::records, 0.0);
+	
+	for (const auto& [word, idf] : HexLoreIndex::weights(query))
+	{
+		const auto& list = HexLoreIndex::postings[HexLoreIndex::dictionary.value(word)];
+		
+		for (auto k = std::size_t(0u); k < list.records.size(); ++k)
+		{
+			const auto record = list.records[k];
+			
+			if (not candidates.testBit(record))
+				continue;
+			
+			const auto frequency = static_cast<double>(list.starts[k + 1u] - list.starts[k]);
+			const auto norm = HexLoreIndex::K1*(1.0 - HexLoreIndex::B + HexLoreIndex::B*HexLoreIndex::lengths[record]/HexLoreIndex::averageLength);
+			
+			result[record] += idf*frequency*(HexLoreIndex::K1 + 1.0)/(frequency + norm);
+		}
+	}
+	
+	return result;
+}
+
+// Distinct indexed words a lowered query asks for, with their inverse document frequency. Excluded terms and unknown words weigh nothing.
+std::vector<std::pair<QString, double>> HexLoreIndex::weights(const QString& query) const
+{
+	const auto tokens = HexLoreIndex::Lex(query);
+	auto result = std::vector<std::pair<QString, double>>();
+	
+	for (auto k = std::size_t(0u); k < tokens.size(); ++k)
+	{
+		if (tokens[k].symbol == Symbol::Not)
+		{
+			++k;
+			continue;
+		}
+		
+		if (tokens[k].symbol != Symbol::Term)
+			continue;
+		
+		for (const auto& word : tokens[k].words)
+		{
+			const auto it = HexLoreIndex::dictionary.constFind(word);
+			const auto known = std::any_of(result.cbegin(), result.cend(), [&word](const auto& weight) { return weight.first == word; });
+			
+			if (HexLoreIndex::dictionary.cend() != it and not known)
+				result.emplace_back(word, HexLoreIndex::inverseFrequency(HexLoreIndex::postings[it.value()]));
+		}
+	}
+	
+	return result;
+}
+
+#endif
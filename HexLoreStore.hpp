@@ -0,0 +1,86 @@
+#ifndef __HEX_LORE_STORE_HPP__
+#define __HEX_LORE_STORE_HPP__
+
+// C++ Libraries
+#include <vector>
+
+// Qt Libraries
+#include <QByteArrayView>
+#include <QString>
+#include <QStringView>
+
+// Lowered descriptions of every record, stored back to back so that a search never has to go back to the disk.
+class HexLoreStore
+{
+	private:
+	
+		QString					corpus;
+		std::vector<qsizetype>			offsets;
+	
+	public:
+	
+		inline void				append(QByteArrayView);
+		inline QStringView			at(quint32) const;
+		inline void				clear(void);
+		inline const QString&			getCorpus(void) const;
+		inline const std::vector<qsizetype>&	getOffsets(void) const;
+		inline bool				isResident(void) const;
+		inline qsizetype			memory(void) const;
+		inline void				reserve(qsizetype, qsizetype);
+		inline void				squeeze(void);
+};
+
+void HexLoreStore::append(QByteArrayView lore)
+{
+	if (HexLoreStore::offsets.empty())
+		HexLoreStore::offsets.push_back(0);
+	
+	HexLoreStore::corpus += QString::fromUtf8(lore).toLower();
+	HexLoreStore::offsets.push_back(HexLoreStore::corpus.size());
+}
+
+QStringView HexLoreStore::at(quint32 index) const
+{
+	const auto start = HexLoreStore::offsets[index];
+	return QStringView(HexLoreStore::corpus).sliced(start, HexLoreStore::offsets[index + 1u] - start);
+}
+
+void HexLoreStore::clear(void)
+{
+	HexLoreStore::corpus.clear();
+	HexLoreStore::offsets.clear();
+}
+
+const QString& HexLoreStore::getCorpus(void) const
+{
+	return HexLoreStore::corpus;
+}
+
+const std::vector<qsizetype>& HexLoreStore::getOffsets(void) const
+{
+	return HexLoreStore::offsets;
+}
+
+bool HexLoreStore::isResident(void) const
+{
+	return (not HexLoreStore::offsets.empty());
+}
+
+qsizetype HexLoreStore::memory(void) const
+{
+	return HexLoreStore::corpus.capacity()*static_cast<qsizetype>(sizeof(QChar)) + static_cast<qsizetype>(HexLoreStore::offsets.capacity()*sizeof(qsizetype));
+}
+
+void HexLoreStore::reserve(qsizetype characters, qsizetype records)
+{
+	HexLoreStore::corpus.reserve(characters);
+	HexLoreStore::offsets.reserve(records + 1);
+}
+
+void HexLoreStore::squeeze(void)
+{
+	HexLoreStore::corpus.squeeze();
+	HexLoreStore::offsets.shrink_to_fit();
+}
+
+#endif
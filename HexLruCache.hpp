@@ -0,0 +1,87 @@
+#ifndef __HEX_LRU_CACHE_HPP__
+#define __HEX_LRU_CACHE_HPP__
+
+// C++ Libraries
+#include <algorithm>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+// Qt Libraries
+#include <QtGlobal>
+
+// Bounded map that forgets the least recently used entry first.
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class HexLruCache
+{
+	private:
+	
+		using Entry = std::pair<Key, Value>;
+		
+		const std::size_t							capacity;
+		std::list<Entry>							entries;
+		std::unordered_map<Key, typename std::list<Entry>::iterator, Hash>	positions;
+	
+	public:
+	
+		inline									HexLruCache(std::size_t);
+		
+		inline void								clear(void);
+		inline const Value*							find(const Key&);
+		inline void								insert(const Key&, Value);
+		inline std::size_t							size(void) const;
+};
+
+template<typename Key, typename Value, typename Hash>
+HexLruCache<Key, Value, Hash>::HexLruCache(std::size_t maximum) : capacity(std::max<std::size_t>(maximum, 1u))
+{
+}
+
+template<typename Key, typename Value, typename Hash>
+void HexLruCache<Key, Value, Hash>::clear(void)
+{
+	HexLruCache::positions.clear();
+	HexLruCache::entries.clear();
+}
+
+template<typename Key, typename Value, typename Hash>
+const Value* HexLruCache<Key, Value, Hash>::find(const Key& key)
+{
+	const auto it = HexLruCache::positions.find(key);
+	
+	if (it == HexLruCache::positions.end())
+		return nullptr;
+	
+	HexLruCache::entries.splice(HexLruCache::entries.begin(), HexLruCache::entries, it->second);
+	return &it->second->second;
+}
+
+template<typename Key, typename Value, typename Hash>
+void HexLruCache<Key, Value, Hash>::insert(const Key& key, Value value)
+{
+	const auto it = HexLruCache::positions.find(key);
+	
+	if (it != HexLruCache::positions.end())
+	{
+		it->second->second = std::move(value);
+		HexLruCache::entries.splice(HexLruCache::entries.begin(), HexLruCache::entries, it->second);
+		return;
+	}
+	
+	if (HexLruCache::entries.size() == HexLruCache::capacity)
+	{
+		HexLruCache::positions.erase(HexLruCache::entries.back().first);
+		HexLruCache::entries.pop_back();
+	}
+	
+	HexLruCache::entries.emplace_front(key, std::move(value));
+	HexLruCache::positions.emplace(key, HexLruCache::entries.begin());
+}
+
+template<typename Key, typename Value, typename Hash>
+std::size_t HexLruCache<Key, Value, Hash>::size(void) const
+{
+	return HexLruCache::entries.size();
+}
+
+#endif
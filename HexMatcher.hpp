@@ -0,0 +1,359 @@
+#ifndef __HEX_MATCHER_HPP__
+#define __HEX_MATCHER_HPP__
+
+// C++ Libraries
+#include <algorithm>
+#include <bit>
+
+#if defined(__x86_64__) and (defined(__GNUC__) or defined(__clang__))
+#ifndef HEX_RUNTIME_DISPATCH
+#define HEX_RUNTIME_DISPATCH
+#endif
+#include <immintrin.h>
+#endif
+
+// Qt Libraries
+#include <QChar>
+#include <QStringView>
+
+// Case-insensitive search of a lowered pattern in text that is not lowered, for mostly Latin-1 text.
+// Characters of the text are folded on the fly, so neither the text nor the pattern is converted twice.
+// The vector kernels keep the positions where the first and the last character of the pattern may sit, and only those are compared in full.
+// When too many of them fail, the rest of the text goes through a Two-Way search, which never compares a character more than twice.
+class HexMatcher
+{
+	private:
+	
+		using Finder = qsizetype (*)(const QChar*, qsizetype, const QChar*, qsizetype);
+		
+		struct Table
+		{
+			Finder					find;
+			const char*				name;
+		};
+		
+		inline static const Table&		Dispatch(void);
+		inline static bool			Equal(const QChar*, const QChar*, qsizetype);
+		inline static bool			Foldable(char16_t);
+		inline static void			MaximalSuffix(const QChar*, qsizetype, bool, qsizetype&, qsizetype&);
+		inline static Table			Select(void);
+		inline static qsizetype			TwoWay(const QChar*, qsizetype, const QChar*, qsizetype);
+		
+		// Failed comparisons allowed to the vector kernels before they hand over, plus one per eight characters of text.
+		static constexpr qsizetype		Budget = 64;
+
+#ifdef HEX_RUNTIME_DISPATCH
+		inline static quint32			CandidatesSSE2(__m128i, __m128i, __m128i);
+		inline static qsizetype			FindSSE2(const QChar*, qsizetype, const QChar*, qsizetype);
+		[[gnu::target("avx2")]] inline static quint32	CandidatesAVX2(__m256i, __m256i, __m256i);
+		[[gnu::target("avx2")]] inline static qsizetype	FindAVX2(const QChar*, qsizetype, const QChar*, qsizetype);
+#endif
+
+	public:
+	
+		inline static bool			Contains(QStringView, QStringView);
+		inline static QChar			Fold(QChar);
+		inline static qsizetype			IndexOf(QStringView, QStringView, qsizetype = 0);
+		inline static const char*		InstructionSet(void);
+};
+
+// The pattern has to be lowered already.
+bool HexMatcher::Contains(QStringView text, QStringView pattern)
+{
+	return (HexMatcher::IndexOf(text, pattern) >= 0);
+}
+
+const HexMatcher::Table& HexMatcher::Dispatch(void)
+{
+	static const auto table = HexMatcher::Select();
+	return table;
+}
+
+bool HexMatcher::Equal(const QChar* text, const QChar* pattern, qsizetype size)
+{
+	for (qsizetype i = 0; i < size; ++i)
+	{
+		if (HexMatcher::Fold(text[i]) != pattern[i])
+			return false;
+	}
+	
+	return true;
+}
+
+// Same as QChar::toLower, without the table lookup for Latin-1.
+QChar HexMatcher::Fold(QChar c)
+{
+	const auto u = c.unicode();
+	
+	if (u < 0x80u)
+		return (u >= 'A' and u <= 'Z' ? QChar(static_cast<char16_t>(u + 0x20u)) : c);
+	
+	if (u <= 0xFFu)
+		return (u >= 0xC0u and u <= 0xDEu and u != 0xD7u ? QChar(static_cast<char16_t>(u + 0x20u)) : c);
+	
+	return c.toLower();
+}
+
+// Lowered Latin-1 letters whose capital is also Latin-1 and differs only by 0x20.
+bool HexMatcher::Foldable(char16_t u)
+{
+	return ((u >= 'a' and u <= 'z') or (u >= 0xE0u and u <= 0xFEu and u != 0xF7u));
+}
+
+// Position of the lowered pattern in the text, from the given position, or -1.
+qsizetype HexMatcher::IndexOf(QStringView text, QStringView pattern, qsizetype from)
+{
+	if (from < 0 or from > text.size())
+		return -1;
+	
+	const auto found = HexMatcher::Dispatch().find(text.data() + from, text.size() - from, pattern.data(), pattern.size());
+	return (found < 0 ? -1 : found + from);
+}
+
+const char* HexMatcher::InstructionSet(void)
+{
+	return HexMatcher::Dispatch().name;
+}
+
+// Start and period of the maximal suffix of the pattern, for the order or, reversed, its opposite.
+void HexMatcher::MaximalSuffix(const QChar* pattern, qsizetype size, bool reversed, qsizetype& start, qsizetype& period)
+{
+	auto j = qsizetype(0);
+	auto k = qsizetype(1);
+	
+	start = -1;
+	period = 1;
+	
+	while (j + k < size)
+	{
+		const auto a = pattern[j + k].unicode();
+		const auto b = pattern[start + k].unicode();
+		
+		if (reversed ? a > b : a < b)
+		{
+			j += k;
+			k = 1;
+			period = j - start;
+		}
+		else if (a == b)
+		{
+			if (k != period)
+				++k;
+			else
+			{
+				j += period;
+				k = 1;
+			}
+		}
+		else
+		{
+			start = j;
+			j = start + 1;
+			k = period = 1;
+		}
+	}
+}
+
+HexMatcher::Table HexMatcher::Select(void)
+{
+#ifdef HEX_RUNTIME_DISPATCH
+	__builtin_cpu_init();
+	
+	if (__builtin_cpu_supports("avx2"))
+		return { HexMatcher::FindAVX2, "AVX2" };
+	
+	return { HexMatcher::FindSSE2, "SSE2" };
+#else
+	return { HexMatcher::TwoWay, "scalar" };
+#endif
+}
+
+// Crochemore and Perrin: the pattern is cut at a critical factorisation, the right part is compared first, then the left one.
+// A periodic pattern remembers how much of its left part is known to match after a shift by the period.
+qsizetype HexMatcher::TwoWay(const QChar* text, qsizetype size, const QChar* pattern, qsizetype length)
+{
+	if (length == 0)
+		return 0;
+	
+	if (size < length)
+		return -1;
+	
+	auto start = qsizetype(0);
+	auto period = qsizetype(0);
+	auto otherStart = qsizetype(0);
+	auto otherPeriod = qsizetype(0);
+	
+	HexMatcher::MaximalSuffix(pattern, length, false, start, period);
+	HexMatcher::MaximalSuffix(pattern, length, true, otherStart, otherPeriod);
+	
+	if (otherStart > start)
+	{
+		start = otherStart;
+		period = otherPeriod;
+	}
+	
+	const auto at = [text](qsizetype i) { return HexMatcher::Fold(text[i]); };
+	
+	if (std::equal(pattern, pattern + start + 1, pattern + period))
+	{
+		auto memory = qsizetype(-1);
+		
+		for (qsizetype j = 0; j <= size - length;)
+		{
+			auto i = std::max(start, memory) + 1;
+			
+			while (i < length and pattern[i] == at(i + j))
+				++i;
+			
+			if (i < length)
+			{
+				j += i - start;
+				memory = -1;
+				continue;
+			}
+			
+			i = start;
+			
+			while (i > memory and pattern[i] == at(i + j))
+				--i;
+			
+			if (i <= memory)
+				return j;
+			
+			j += period;
+			memory = length - period - 1;
+		}
+	}
+	else
+	{
+		const auto shift = std::max(start + 1, length - start - 1) + 1;
+		
+		for (qsizetype j = 0; j <= size - length;)
+		{
+			auto i = start + 1;
+			
+			while (i < length and pattern[i] == at(i + j))
+				++i;
+			
+			if (i < length)
+			{
+				j += i - start;
+				continue;
+			}
+			
+			i = start;
+			
+			while (i >= 0 and pattern[i] == at(i + j))
+				--i;
+			
+			if (i < 0)
+				return j;
+			
+			j += shift;
+		}
+	}
+	
+	return -1;
+}
+
+#ifdef HEX_RUNTIME_DISPATCH
+// A text unit may hold the character c when, with 0x20 set for a foldable c, it equals c, or when it is outside Latin-1 and has to be folded by Qt.
+// Two bits of the mask per unit.
+quint32 HexMatcher::CandidatesSSE2(__m128i units, __m128i c, __m128i fold)
+{
+	const auto equal = static_cast<quint32>(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_or_si128(units, fold), c)));
+	const auto latin = static_cast<quint32>(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_srli_epi16(units, 8), _mm_setzero_si128())));
+	return (equal | (compl(latin) & 0xFFFFu));
+}
+
+quint32 HexMatcher::CandidatesAVX2(__m256i units, __m256i c, __m256i fold)
+{
+	const auto equal = static_cast<quint32>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_or_si256(units, fold), c)));
+	const auto latin = static_cast<quint32>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_srli_epi16(units, 8), _mm256_setzero_si256())));
+	return (equal | compl(latin));
+}
+
+qsizetype HexMatcher::FindSSE2(const QChar* text, qsizetype size, const QChar* pattern, qsizetype length)
+{
+	if (length == 0 or size < length)
+		return (length == 0 ? 0 : -1);
+	
+	const auto first = pattern[0].unicode();
+	const auto last = pattern[length - 1].unicode();
+	const auto firstChar = _mm_set1_epi16(static_cast<short>(first));
+	const auto lastChar = _mm_set1_epi16(static_cast<short>(last));
+	const auto firstCase = _mm_set1_epi16(HexMatcher::Foldable(first) ? 0x20 : 0);
+	const auto lastCase = _mm_set1_epi16(HexMatcher::Foldable(last) ? 0x20 : 0);
+	
+	auto failures = qsizetype(0);
+	auto i = qsizetype(0);
+	
+	for (; i + length - 1 + 8 <= size; i += 8)
+	{
+		const auto head = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+		const auto tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i + length - 1));
+		
+		for (auto mask = HexMatcher::CandidatesSSE2(head, firstChar, firstCase) & HexMatcher::CandidatesSSE2(tail, lastChar, lastCase); mask != 0u; mask &= compl(3u << std::countr_zero(mask)))
+		{
+			const auto position = i + std::countr_zero(mask)/2;
+			
+			if (HexMatcher::Equal(text + position, pattern, length))
+				return position;
+			
+			++failures;
+		}
+		
+		if (failures > HexMatcher::Budget + i/8)
+		{
+			i += 8;
+			break;
+		}
+	}
+	
+	const auto found = HexMatcher::TwoWay(text + i, size - i, pattern, length);
+	return (found < 0 ? -1 : found + i);
+}
+
+qsizetype HexMatcher::FindAVX2(const QChar* text, qsizetype size, const QChar* pattern, qsizetype length)
+{
+	if (length == 0 or size < length)
+		return (length == 0 ? 0 : -1);
+	
+	const auto first = pattern[0].unicode();
+	const auto last = pattern[length - 1].unicode();
+	const auto firstChar = _mm256_set1_epi16(static_cast<short>(first));
+	const auto lastChar = _mm256_set1_epi16(static_cast<short>(last));
+	const auto firstCase = _mm256_set1_epi16(HexMatcher::Foldable(first) ? 0x20 : 0);
+	const auto lastCase = _mm256_set1_epi16(HexMatcher::Foldable(last) ? 0x20 : 0);
+	
+	auto failures = qsizetype(0);
+	auto i = qsizetype(0);
+	
+	for (; i + length - 1 + 16 <= size; i += 16)
+	{
+		const auto head = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+		const auto tail = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i + length - 1));
+		
+		for (auto mask = HexMatcher::CandidatesAVX2(head, firstChar, firstCase) & HexMatcher::CandidatesAVX2(tail, lastChar, lastCase); mask != 0u; mask &= compl(3u << std::countr_zero(mask)))
+		{
+			const auto position = i + std::countr_zero(mask)/2;
+			
+			if (HexMatcher::Equal(text + position, pattern, length))
+				return position;
+			
+			++failures;
+		}
+		
+		if (failures > HexMatcher::Budget + i/8)
+		{
+			i += 16;
+			break;
+		}
+	}
+	
+	const auto found = HexMatcher::TwoWay(text + i, size - i, pattern, length);
+	return (found < 0 ? -1 : found + i);
+}
+#endif
+
+#endif
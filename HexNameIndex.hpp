@@ -0,0 +1,194 @@
+#ifndef __HEX_NAME_INDEX_HPP__
+#define __HEX_NAME_INDEX_HPP__
+
+// C++ Libraries
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+// Qt Libraries
+#include <QString>
+
+// Custom Libraries
+#include "HexBitmap.hpp"
+#include "HexFile.hpp"
+#include "HexLoreIndex.hpp"
+#include "HexMatcher.hpp"
+
+// Lowered names of every record, with the list of records containing each trigram.
+// A record holding a pattern holds every trigram of it, so intersecting their postings leaves only a handful of names to check.
+// Patterns shorter than a trigram are checked against every lowered name.
+template<quint32 Number>
+class HexNameIndex
+{
+	private:
+	
+		static constexpr qsizetype			Gram = 3;
+		
+		inline static quint64				Key(const QChar*);
+		
+		std::vector<QString>				names;
+		std::vector<quint64>				keys;
+		std::vector<quint32>				starts;
+		std::vector<quint32>				postings;
+		
+		inline std::pair<const quint32*, const quint32*>	find(quint64) const;
+	
+	public:
+	
+		inline void					build(const std::vector<HexFile<Number>>&);
+		inline bool					contains(quint32, const QString&) const;
+		inline bool					containsWord(quint32, const QString&) const;
+		inline HexBitmap				match(const QString&) const;
+		inline qsizetype				memory(void) const;
+		inline quint32					size(void) const;
+};
+
+// Three UTF-16 units side by side.
+template<quint32 Number>
+quint64 HexNameIndex<Number>::Key(const QChar* gram)
+{
+	return (static_cast<quint64>(gram[0].unicode()) << 32) | (static_cast<quint64>(gram[1].unicode()) << 16) | static_cast<quint64>(gram[2].unicode());
+}
+
+template<quint32 Number>
+void HexNameIndex<Number>::build(const std::vector<HexFile<Number>>& files)
+{
+	auto pairs = std::vector<std::pair<quint64, quint32>>();
+	
+	HexNameIndex::names.clear();
+	HexNameIndex::names.reserve(files.size());
+	
+	for (auto index = 0u; index < files.size(); ++index)
+	{
+		const auto name = files[index].name.toLower();
+		
+		for (qsizetype i = 0; i + HexNameIndex::Gram <= name.size(); ++i)
+			pairs.emplace_back(HexNameIndex::Key(name.constData() + i), index);
+		
+		HexNameIndex::names.push_back(name);
+	}
+	
+	// Sorting by trigram, then record, gives sorted postings; a trigram repeated within a name is kept once.
+	std::sort(pairs.begin(), pairs.end());
+	pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+	
+	HexNameIndex::keys.clear();
+	HexNameIndex::starts.clear();
+	HexNameIndex::postings.clear();
+	HexNameIndex::postings.reserve(pairs.size());
+	
+	for (const auto& [key, index] : pairs)
+	{
+		if (HexNameIndex::keys.empty() or HexNameIndex::keys.back() != key)
+		{
+			HexNameIndex::keys.push_back(key);
+			HexNameIndex::starts.push_back(static_cast<quint32>(HexNameIndex::postings.size()));
+		}
+		
+		HexNameIndex::postings.push_back(index);
+	}
+	
+	HexNameIndex::starts.push_back(static_cast<quint32>(HexNameIndex::postings.size()));
+}
+
+// The pattern has to be lowered already.
+template<quint32 Number>
+bool HexNameIndex<Number>::contains(quint32 index, const QString& pattern) const
+{
+	return HexMatcher::Contains(HexNameIndex::names[index], pattern);
+}
+
+// The word has to be lowered already. Names are cut into words as descriptions are, so that "ray" is a word of "Ray of Frost" and not of "Prayer".
+template<quint32 Number>
+bool HexNameIndex<Number>::containsWord(quint32 index, const QString& word) const
+{
+	auto found = false;
+	HexLoreIndex::Tokenise(HexNameIndex::names[index], [&found, &word](QStringView token, quint32) { found = (found or token == word); });
+	
+	return found;
+}
+
+template<quint32 Number>
+std::pair<const quint32*, const quint32*> HexNameIndex<Number>::find(quint64 key) const
+{
+	const auto it = std::lower_bound(HexNameIndex::keys.cbegin(), HexNameIndex::keys.cend(), key);
+	
+	if (HexNameIndex::keys.cend() == it or *it != key)
+		return { nullptr, nullptr };
+	
+	const auto k = static_cast<std::size_t>(it - HexNameIndex::keys.cbegin());
+	return { HexNameIndex::postings.data() + HexNameIndex::starts[k], HexNameIndex::postings.data() + HexNameIndex::starts[k + 1u] };
+}
+
+// Every record whose name contains the lowered pattern.
+template<quint32 Number>
+HexBitmap HexNameIndex<Number>::match(const QString& pattern) const
+{
+	const auto records = HexNameIndex::size();
+	auto result = HexBitmap(records, false);
+	
+	if (pattern.size() < HexNameIndex::Gram)
+	{
+		for (auto index = 0u; index < records; ++index)
+		{
+			if (HexNameIndex::contains(index, pattern))
+				result.setBit(index);
+		}
+		
+		return result;
+	}
+	
+	auto lists = std::vector<std::pair<const quint32*, const quint32*>>();
+	
+	for (qsizetype i = 0; i + HexNameIndex::Gram <= pattern.size(); ++i)
+	{
+		const auto list = HexNameIndex::find(HexNameIndex::Key(pattern.constData() + i));
+		
+		if (list.first == nullptr)
+			return result;
+		
+		lists.push_back(list);
+	}
+	
+	// Starting from the rarest trigram keeps every intermediate list as short as possible.
+	std::sort(lists.begin(), lists.end(), [](const auto& a, const auto& b) { return a.second - a.first < b.second - b.first; });
+	
+	auto candidates = std::vector<quint32>(lists.front().first, lists.front().second);
+	auto buffer = std::vector<quint32>();
+	
+	for (auto it = lists.cbegin() + 1; lists.cend() != it and not candidates.empty(); ++it)
+	{
+		buffer.clear();
+		std::set_intersection(candidates.cbegin(), candidates.cend(), it->first, it->second, std::back_inserter(buffer));
+		std::swap(candidates, buffer);
+	}
+	
+	for (const auto index : candidates)
+	{
+		if (HexNameIndex::contains(index, pattern))
+			result.setBit(index);
+	}
+	
+	return result;
+}
+
+template<quint32 Number>
+qsizetype HexNameIndex<Number>::memory(void) const
+{
+	auto result = static_cast<qsizetype>(HexNameIndex::keys.capacity()*sizeof(quint64) + (HexNameIndex::starts.capacity() + HexNameIndex::postings.capacity())*sizeof(quint32));
+	
+	for (const auto& name : HexNameIndex::names)
+		result += name.capacity()*static_cast<qsizetype>(sizeof(QChar));
+	
+	return result;
+}
+
+template<quint32 Number>
+quint32 HexNameIndex<Number>::size(void) const
+{
+	return static_cast<quint32>(HexNameIndex::names.size());
+}
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef __HEX_NAME_TREE_HPP__
+#define __HEX_NAME_TREE_HPP__
+
+// C++ Libraries
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// Qt Libraries
+#include <QString>
+#include <QStringView>
+
+// BK-tree over lowered names: the children of a node are filed under their edit distance to it.
+// By the triangle inequality, names within k of a query hang under edges between d - k and d + k of every node at distance d, so a search with a small k only walks a few branches.
+template<typename Value>
+class HexNameTree
+{
+	private:
+	
+		struct Node
+		{
+			QString					name;
+			QString					key;
+			Value					value;
+			std::vector<std::pair<quint32, quint32>>	children;
+		};
+		
+		inline static quint32			Distance(QStringView, QStringView, std::vector<quint32>&);
+		
+		std::vector<Node>			nodes;
+	
+	public:
+	
+		struct Match
+		{
+			QString					name;
+			Value					value;
+			quint32					distance;
+		};
+		
+		inline void				clear(void);
+		inline void				insert(const QString&, Value);
+		template<typename Function> inline std::vector<Match>	search(const QString&, quint32, std::size_t, Function) const;
+		inline quint32				size(void) const;
+};
+
+template<typename Value>
+void HexNameTree<Value>::clear(void)
+{
+	HexNameTree::nodes.clear();
+}
+
+// Levenshtein distance, one row at a time.
+template<typename Value>
+quint32 HexNameTree<Value>::Distance(QStringView a, QStringView b, std::vector<quint32>& row)
+{
+	row.resize(static_cast<std::size_t>(b.size()) + 1u);
+	
+	for (auto j = std::size_t(0u); j < row.size(); ++j)
+		row[j] = static_cast<quint32>(j);
+	
+	for (qsizetype i = 0; i < a.size(); ++i)
+	{
+		auto diagonal = row[0];
+		row[0] = static_cast<quint32>(i + 1);
+		
+		for (qsizetype j = 0; j < b.size(); ++j)
+		{
+			const auto k = static_cast<std::size_t>(j) + 1u;
+			const auto above = row[k];
+			
+			row[k] = std::min({ row[k] + 1u, row[k - 1u] + 1u, diagonal + (a[i] == b[j] ? 0u : 1u) });
+			diagonal = above;
+		}
+	}
+	
+	return row.back();
+}
+
+// A name given twice hangs under the first copy, at distance zero.
+template<typename Value>
+void HexNameTree<Value>::insert(const QString& name, Value value)
+{
+	auto key = name.toLower();
+	auto row = std::vector<quint32>();
+	
+	if (HexNameTree::nodes.empty())
+	{
+		HexNameTree::nodes.push_back({ name, std::move(key), std::move(value), {} });
+		return;
+	}
+	
+	auto current = std::size_t(0u);
+	
+	while (true)
+	{
+		const auto distance = HexNameTree::Distance(key, HexNameTree::nodes[current].key, row);
+		const auto& children = HexNameTree::nodes[current].children;
+		const auto it = std::find_if(children.cbegin(), children.cend(), [distance](const auto& child) { return child.first == distance; });
+		
+		if (children.cend() == it)
+		{
+			HexNameTree::nodes[current].children.emplace_back(distance, static_cast<quint32>(HexNameTree::nodes.size()));
+			HexNameTree::nodes.push_back({ name, std::move(key), std::move(value), {} });
+			return;
+		}
+		
+		current = it->second;
+	}
+}
+
+// Up to limit names within the distance of the query, nearest first, among those whose value passes the filter.
+template<typename Value>
+template<typename Function>
+std::vector<typename HexNameTree<Value>::Match> HexNameTree<Value>::search(const QString& query, quint32 tolerance, std::size_t limit, Function accept) const
+{
+	auto result = std::vector<Match>();
+	
+	if (HexNameTree::nodes.empty())
+		return result;
+	
+	const auto key = query.toLower();
+	auto row = std::vector<quint32>();
+	auto pending = std::vector<quint32>({ 0u });
+	auto found = std::vector<std::pair<quint32, quint32>>();
+	
+	while (not pending.empty())
+	{
+		const auto& node = HexNameTree::nodes[pending.back()];
+		const auto index = pending.back();
+		pending.pop_back();
+		
+		const auto distance = HexNameTree::Distance(key, node.key, row);
+		
+		if (distance <= tolerance and accept(node.value))
+			found.emplace_back(distance, index);
+		
+		for (const auto& [edge, child] : node.children)
+		{
+			if (edge + tolerance >= distance and edge <= distance + tolerance)
+				pending.push_back(child);
+		}
+	}
+	
+	// Ties go to the name that comes first, so the answer does not depend on the shape of the tree.
+	std::sort(found.begin(), found.end(), [this](const auto& a, const auto& b) { return (a.first != b.first ? a.first < b.first : HexNameTree::nodes[a.second].key < HexNameTree::nodes[b.second].key); });
+	
+	for (auto i = std::size_t(0u); i < found.size() and i < limit; ++i)
+	{
+		const auto& node = HexNameTree::nodes[found[i].second];
+		result.push_back({ node.name, node.value, found[i].first });
+	}
+	
+	return result;
+}
+
+template<typename Value>
+quint32 HexNameTree<Value>::size(void) const
+{
+	return static_cast<quint32>(HexNameTree::nodes.size());
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef __HEX_PARALLEL_HPP__
+#define __HEX_PARALLEL_HPP__
+
+// C++ Libraries
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+// Qt Libraries
+#include <QFuture>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+// Spreads numbered chunks of work over the global thread pool.
+// Workers claim the next chunk from a shared counter, so a thread that finishes early simply takes more; the calling thread works too.
+class HexParallel
+{
+	public:
+	
+		template<typename Function> inline static void	For(quint32, quint32, Function);
+		inline static quint32				Threads(void);
+};
+
+template<typename Function>
+void HexParallel::For(quint32 chunks, quint32 threads, Function function)
+{
+	threads = std::min(threads, chunks);
+	
+	if (threads <= 1u)
+	{
+		for (auto chunk = 0u; chunk < chunks; ++chunk)
+			function(chunk);
+		
+		return;
+	}
+	
+	auto next = std::atomic<quint32>(0u);
+	
+	const auto worker = [&next, &function, chunks](void)
+	{
+		for (auto chunk = next++; chunk < chunks; chunk = next++)
+			function(chunk);
+	};
+	
+	auto futures = std::vector<QFuture<void>>();
+	futures.reserve(threads - 1u);
+	
+	for (auto i = 1u; i < threads; ++i)
+		futures.push_back(QtConcurrent::run(worker));
+	
+	worker();
+	
+	for (auto& future : futures)
+		future.waitForFinished();
+}
+
+// DND_THREADS overrides the size of the pool, which is how the scaling is measured.
+quint32 HexParallel::Threads(void)
+{
+	auto ok = false;
+	const auto threads = qEnvironmentVariableIntValue("DND_THREADS", &ok);
+	
+	if (ok and threads > 0)
+		return static_cast<quint32>(threads);
+	
+	return static_cast<quint32>(std::max(QThreadPool::globalInstance()->maxThreadCount(), 1));
+}
+
+#endif
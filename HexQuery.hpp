@@ -0,0 +1,139 @@
+#ifndef __HEX_QUERY_HPP__
+#define __HEX_QUERY_HPP__
+
+// C++ Libraries
+#include <algorithm>
+#include <vector>
+
+// Qt Libraries
+#include <QHash>
+#include <QString>
+
+// Custom Libraries
+#include "HexBitset.hpp"
+
+// Everything a search depends on, independent of the buttons it was read from.
+template<quint32 Number>
+struct HexQuery
+{
+	HexBitset<Number>			greenBitset;
+	HexBitset<Number>			redBitset;
+	std::vector<HexBitset<Number>>		yellowBitsets;
+	
+	QString					nameSearch;
+	QString					loreSearch;
+	QString					classSearch;
+	bool					barNames = false;
+	bool					barTexts = false;
+	bool					wordSearch = false;
+	bool					ranked = false;
+	
+	struct Hash
+	{
+		std::size_t operator()(const HexQuery& query) const
+		{
+			return query.hash();
+		}
+	};
+	
+	// With a bar toggle, a shorter pattern excludes more records; without, a longer one keeps fewer.
+	static bool NarrowsText(const QString& text, bool bar, const QString& previousText, bool previousBar)
+	{
+		if (previousText.isEmpty())
+			return true;
+		
+		if (bar != previousBar)
+			return false;
+		
+		return (bar ? not text.isEmpty() and previousText.contains(text) : text.contains(previousText));
+	}
+	
+	static bool Less(const HexBitset<Number>& a, const HexBitset<Number>& b)
+	{
+		return std::lexicographical_compare(a.data(), a.data() + HexBitset<Number>::ARRAY_SIZE, b.data(), b.data() + HexBitset<Number>::ARRAY_SIZE);
+	}
+	
+	static bool Same(const HexBitset<Number>& a, const HexBitset<Number>& b)
+	{
+		return std::equal(a.data(), a.data() + HexBitset<Number>::ARRAY_SIZE, b.data());
+	}
+	
+	// Two button setups selecting the same yellow groups in another order, or a bar toggle without text, give the same query.
+	// Scores count whole words, so only a word search is ranked: a substring match without any would score nothing.
+	void normalise(void)
+	{
+		std::sort(HexQuery::yellowBitsets.begin(), HexQuery::yellowBitsets.end(), HexQuery::Less);
+		HexQuery::yellowBitsets.erase(std::unique(HexQuery::yellowBitsets.begin(), HexQuery::yellowBitsets.end(), HexQuery::Same), HexQuery::yellowBitsets.end());
+		
+		HexQuery::barNames = (HexQuery::barNames and not HexQuery::nameSearch.isEmpty());
+		HexQuery::barTexts = (HexQuery::barTexts and not HexQuery::loreSearch.isEmpty());
+		HexQuery::wordSearch = (HexQuery::wordSearch and not HexQuery::loreSearch.isEmpty());
+		HexQuery::ranked = (HexQuery::ranked and HexQuery::wordSearch);
+		HexQuery::classSearch = HexQuery::classSearch.trimmed();
+	}
+	
+	std::size_t hash(void) const
+	{
+		auto result = static_cast<std::size_t>(14695981039346656037llu);
+		
+		const auto mix = [&result](const HexBitset<Number>& bitset)
+		{
+			for (auto i = 0u; i < HexBitset<Number>::ARRAY_SIZE; ++i)
+				result = (result ^ static_cast<std::size_t>(bitset.data()[i]))*static_cast<std::size_t>(1099511628211llu);
+		};
+		
+		mix(HexQuery::greenBitset);
+		mix(HexQuery::redBitset);
+		
+		for (const auto& yellowBitset : HexQuery::yellowBitsets)
+			mix(yellowBitset);
+		
+		result = qHash(HexQuery::nameSearch, result);
+		result = qHash(HexQuery::loreSearch, result);
+		result = qHash(HexQuery::classSearch, result);
+		
+		return result ^ (static_cast<std::size_t>(HexQuery::ranked) << 3u) ^ (static_cast<std::size_t>(HexQuery::wordSearch) << 2u) ^ (static_cast<std::size_t>(HexQuery::barNames) << 1u) ^ static_cast<std::size_t>(HexQuery::barTexts);
+	}
+	
+	// True when every record matching this query also matches the previous one, so that only the previous results need filtering.
+	// A ranked search only kept its best records, so nothing narrows it.
+	bool narrows(const HexQuery& previous) const
+	{
+		if (previous.ranked)
+			return false;
+		
+		if (not HexQuery::greenBitset.all(previous.greenBitset) or not HexQuery::redBitset.all(previous.redBitset))
+			return false;
+		
+		for (const auto& group : previous.yellowBitsets)
+		{
+			const auto stricter = std::any_of(HexQuery::yellowBitsets.cbegin(), HexQuery::yellowBitsets.cend(), [&group](const HexBitset<Number>& mine) { return group.all(mine); });
+			
+			if (not stricter)
+				return false;
+		}
+		
+		if (not HexQuery::NarrowsText(HexQuery::nameSearch, HexQuery::barNames, previous.nameSearch, previous.barNames))
+			return false;
+		
+		// Class terms are all required, so adding a filter narrows, but a changed one may not.
+		if (not previous.classSearch.isEmpty() and HexQuery::classSearch != previous.classSearch)
+			return false;
+		
+		// A word query is not a substring, so only an unchanged one is known to keep the same records.
+		if (HexQuery::wordSearch or previous.wordSearch)
+			return (previous.loreSearch.isEmpty() or (HexQuery::wordSearch == previous.wordSearch and HexQuery::barTexts == previous.barTexts and HexQuery::loreSearch == previous.loreSearch));
+		
+		return HexQuery::NarrowsText(HexQuery::loreSearch, HexQuery::barTexts, previous.loreSearch, previous.barTexts);
+	}
+	
+	bool operator==(const HexQuery& query) const
+	{
+		const auto sameYellows = std::equal(HexQuery::yellowBitsets.cbegin(), HexQuery::yellowBitsets.cend(), query.yellowBitsets.cbegin(), query.yellowBitsets.cend(), HexQuery::Same);
+		
+		return (HexQuery::Same(HexQuery::greenBitset, query.greenBitset) and HexQuery::Same(HexQuery::redBitset, query.redBitset) and sameYellows
+			and HexQuery::nameSearch == query.nameSearch and HexQuery::loreSearch == query.loreSearch and HexQuery::classSearch == query.classSearch and HexQuery::barNames == query.barNames and HexQuery::barTexts == query.barTexts and HexQuery::wordSearch == query.wordSearch and HexQuery::ranked == query.ranked);
+	}
+};
+
+#endif
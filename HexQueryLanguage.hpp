@@ -0,0 +1,335 @@
+#ifndef __HEX_QUERY_LANGUAGE_HPP__
+#define __HEX_QUERY_LANGUAGE_HPP__
+
+// C++ Libraries
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// Qt Libraries
+#include <QHash>
+#include <QString>
+#include <QStringView>
+
+// Custom Libraries
+#include "HexQuery.hpp"
+
+// Typed queries such as: school:evocation level:1..3 -descriptor:fire lore:"ray"
+// A term is an optional sign, an optional field and a value; a value is a label, a quoted label, a range of numbered labels (1..3) or several of them separated by commas.
+// Fields are the groups of buttons, by their title or any word of it, singular or plural; a term without a field looks in every group.
+// A term naming one flag requires it (green), several flags give a group of which one is required (yellow), and a minus excludes them all (red).
+// The name, lore and class fields fill the text searches instead; a minus before name or lore bars the text.
+class HexQueryLanguage
+{
+	private:
+	
+		struct Entry
+		{
+			quint32					group;
+			std::vector<quint32>			bits;
+		};
+		
+		struct Term
+		{
+			bool					negated;
+			QStringView				field;
+			QStringView				value;
+		};
+		
+		inline static QString			Compact(QStringView);
+		inline static bool			Next(QStringView, qsizetype&, Term&);
+		
+		QHash<QString, std::vector<quint32>>	fields;
+		QHash<QString, std::vector<Entry>>	entries;
+		std::vector<std::vector<std::pair<quint32, std::vector<quint32>>>>	numbers;
+		std::vector<QString>			titles;
+		
+		inline bool				resolve(QStringView, QStringView, std::vector<quint32>&, QString&) const;
+	
+	public:
+	
+		inline void				addEntry(quint32, const QString&, const std::vector<quint32>&);
+		inline quint32				addGroup(const QString&);
+		inline void				clear(void);
+		template<quint32 Number> inline bool	compile(QStringView, HexQuery<Number>&, QString&) const;
+		inline bool				isEmpty(void) const;
+};
+
+// A label of the group, with every flag it stands for: one for a button, all those of its window for a button opening one.
+void HexQueryLanguage::addEntry(quint32 group, const QString& label, const std::vector<quint32>& bits)
+{
+	if (bits.empty())
+		return;
+	
+	HexQueryLanguage::entries[HexQueryLanguage::Compact(label)].push_back({ group, bits });
+	
+	auto ok = false;
+	const auto number = label.trimmed().toUInt(&ok);
+	
+	if (ok)
+		HexQueryLanguage::numbers[group].emplace_back(number, bits);
+}
+
+// The group answers to its whole title and to every word of it, with or without a plural ending.
+quint32 HexQueryLanguage::addGroup(const QString& title)
+{
+	const auto group = static_cast<quint32>(HexQueryLanguage::titles.size());
+	auto names = title.toLower().split(' ', Qt::SkipEmptyParts);
+	names.push_back(HexQueryLanguage::Compact(title));
+	
+	for (const auto& name : names)
+	{
+		const auto word = HexQueryLanguage::Compact(name);
+		auto forms = std::vector<QString>({ word });
+		
+		if (word.endsWith("es"))
+			forms.push_back(word.chopped(2));
+		
+		if (word.endsWith(u's'))
+			forms.push_back(word.chopped(1));
+		
+		for (const auto& form : forms)
+		{
+			auto& groups = HexQueryLanguage::fields[form];
+			
+			if (not form.isEmpty() and std::find(groups.cbegin(), groups.cend(), group) == groups.cend())
+				groups.push_back(group);
+		}
+	}
+	
+	HexQueryLanguage::titles.push_back(title);
+	HexQueryLanguage::numbers.emplace_back();
+	return group;
+}
+
+void HexQueryLanguage::clear(void)
+{
+	HexQueryLanguage::fields.clear();
+	HexQueryLanguage::entries.clear();
+	HexQueryLanguage::numbers.clear();
+	HexQueryLanguage::titles.clear();
+}
+
+// Lowered letters and digits only, so that "Mind-Affecting", "mind affecting" and mind_affecting are the same label.
+QString HexQueryLanguage::Compact(QStringView text)
+{
+	auto result = QString();
+	result.reserve(text.size());
+	
+	for (const auto c : text)
+	{
+		if (c.isLetterOrNumber())
+			result += c.toLower();
+	}
+	
+	return result;
+}
+
+// Adds the terms of the text to the query, which usually comes from the buttons; its name, lore and class terms replace those of the line edits.
+// Nothing is changed when a term does not read, and the error says which one.
+template<quint32 Number>
+bool HexQueryLanguage::compile(QStringView text, HexQuery<Number>& query, QString& error) const
+{
+	auto result = query;
+	auto classTerms = QStringList();
+	auto position = qsizetype(0);
+	auto term = Term();
+	auto nameSet = false;
+	auto loreSet = false;
+	
+	while (HexQueryLanguage::Next(text, position, term))
+	{
+		const auto field = HexQueryLanguage::Compact(term.field);
+		
+		if (field == "name" or field == "lore")
+		{
+			const auto isName = (field == "name");
+			auto& set = (isName ? nameSet : loreSet);
+			
+			if (set or term.value.isEmpty())
+			{
+				error = "Give one non-empty " + field + " term at most.";
+				return false;
+			}
+			
+			(isName ? result.nameSearch : result.loreSearch) = term.value.toString().toLower();
+			(isName ? result.barNames : result.barTexts) = term.negated;
+			set = true;
+			continue;
+		}
+		
+		if (field == "class")
+		{
+			if (term.negated)
+			{
+				error = "Class levels cannot be excluded.";
+				return false;
+			}
+			
+			classTerms.push_back(term.value.toString().toLower());
+			continue;
+		}
+		
+		auto bits = std::vector<quint32>();
+		
+		if (not HexQueryLanguage::resolve(term.field, term.value, bits, error))
+			return false;
+		
+		if (term.negated)
+		{
+			for (const auto bit : bits)
+				result.redBitset.setBit(bit);
+		}
+		else if (bits.size() == 1u)
+			result.greenBitset.setBit(bits.front());
+		else
+		{
+			auto& yellowBitset = result.yellowBitsets.emplace_back();
+			
+			for (const auto bit : bits)
+				yellowBitset.setBit(bit);
+		}
+	}
+	
+	if (not classTerms.isEmpty())
+		result.classSearch = classTerms.join(',');
+	
+	query = std::move(result);
+	return true;
+}
+
+bool HexQueryLanguage::isEmpty(void) const
+{
+	return HexQueryLanguage::titles.empty();
+}
+
+// Reads the term starting at the position and moves past it, or returns false at the end of the text.
+// A quote runs to the next one, or to the end of the text while it is being typed.
+bool HexQueryLanguage::Next(QStringView text, qsizetype& position, Term& term)
+{
+	while (position < text.size() and text[position].isSpace())
+		++position;
+	
+	if (position == text.size())
+		return false;
+	
+	term.negated = (text[position] == '-');
+	term.field = QStringView();
+	
+	if (text[position] == '-' or text[position] == '+')
+		++position;
+	
+	const auto read = [&text, &position](void)
+	{
+		const auto start = position;
+		
+		if (position < text.size() and text[position] == '"')
+		{
+			const auto close = text.indexOf(u'"', start + 1);
+			position = (close < 0 ? text.size() : close + 1);
+			return text.sliced(start + 1, (close < 0 ? text.size() : close) - start - 1);
+		}
+		
+		while (position < text.size() and not text[position].isSpace() and text[position] != ':' and text[position] != '"')
+			++position;
+		
+		return text.sliced(start, position - start);
+	};
+	
+	term.value = read();
+	
+	if (position < text.size() and text[position] == ':')
+	{
+		++position;
+		term.field = term.value;
+		term.value = read();
+	}
+	
+	return true;
+}
+
+// Flags of every alternative of the value among the groups of the field, or all of them without one.
+bool HexQueryLanguage::resolve(QStringView field, QStringView value, std::vector<quint32>& bits, QString& error) const
+{
+	auto groups = std::vector<quint32>();
+	
+	if (field.isEmpty())
+	{
+		for (auto group = 0u; group < HexQueryLanguage::titles.size(); ++group)
+			groups.push_back(group);
+	}
+	else
+	{
+		const auto it = HexQueryLanguage::fields.constFind(HexQueryLanguage::Compact(field));
+		
+		if (HexQueryLanguage::fields.cend() == it)
+		{
+			error = "Unknown field \"" + field.toString() + "\".";
+			return false;
+		}
+		
+		groups = it.value();
+	}
+	
+	const auto where = (field.isEmpty() ? QString() : " in " + HexQueryLanguage::titles[groups.front()]);
+	
+	for (const auto alternative : value.tokenize(u',', Qt::SkipEmptyParts))
+	{
+		const auto before = bits.size();
+		const auto range = alternative.indexOf(u"..");
+		
+		if (range >= 0)
+		{
+			auto lowOk = false;
+			auto highOk = false;
+			const auto low = alternative.first(range).trimmed().toUInt(&lowOk);
+			const auto high = alternative.sliced(range + 2).trimmed().toUInt(&highOk);
+			
+			if (not lowOk or not highOk)
+			{
+				error = "\"" + alternative.toString() + "\" is not a range.";
+				return false;
+			}
+			
+			for (const auto group : groups)
+			{
+				for (const auto& [number, flags] : HexQueryLanguage::numbers[group])
+				{
+					if (number >= low and number <= high)
+						bits.insert(bits.end(), flags.cbegin(), flags.cend());
+				}
+			}
+		}
+		else
+		{
+			const auto it = HexQueryLanguage::entries.constFind(HexQueryLanguage::Compact(alternative));
+			
+			if (HexQueryLanguage::entries.cend() != it)
+			{
+				for (const auto& entry : it.value())
+				{
+					if (std::find(groups.cbegin(), groups.cend(), entry.group) != groups.cend())
+						bits.insert(bits.end(), entry.bits.cbegin(), entry.bits.cend());
+				}
+			}
+		}
+		
+		if (bits.size() == before)
+		{
+			error = "Nothing matches \"" + alternative.toString() + "\"" + where + ".";
+			return false;
+		}
+	}
+	
+	if (bits.empty())
+	{
+		error = "Give a value" + (field.isEmpty() ? QString() : " to " + field.toString()) + ".";
+		return false;
+	}
+	
+	std::sort(bits.begin(), bits.end());
+	bits.erase(std::unique(bits.begin(), bits.end()), bits.end());
+	return true;
+}
+
+#endif
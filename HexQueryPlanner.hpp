@@ -0,0 +1,430 @@
+#ifndef __HEX_QUERY_PLANNER_HPP__
+#define __HEX_QUERY_PLANNER_HPP__
+
+// C++ Libraries
+#include <algorithm>
+#include <vector>
+
+// Qt Libraries
+#include <QString>
+#include <QStringList>
+
+// Custom Libraries
+#include "HexBitmap.hpp"
+#include "HexBitmapIndex.hpp"
+#include "HexParallel.hpp"
+#include "HexQuery.hpp"
+
+// Orders the predicates of a search from the flag frequencies gathered at load. Without statistics on text, the name and lore tests are assumed to keep half of their input.
+// Groups that cannot remove a record are dropped, bitmap steps run most selective first, then the name test, and the lore test always comes last.
+template<quint32 Number>
+class HexQueryPlanner
+{
+	public:
+	
+		enum class Kind
+		{
+			Require,
+			Exclude,
+			AnyOf,
+			Name,
+			Lore
+		};
+		
+		struct Step
+		{
+			Kind					kind;
+			HexBitset<Number>			bits;
+			bool					rows = false;
+			double					keep = 1.0;
+			quint32					estimatedRemoved = 0u;
+			quint32					actualRemoved = 0u;
+			quint32					left = 0u;
+			bool					executed = false;
+			const char*				reason = nullptr;
+		};
+	
+	private:
+	
+		static constexpr double				TextKeep = 0.5;
+		static constexpr quint32			ChunkWords = 1u;
+		
+		const HexBitmapIndex<Number>&			bitmapIndex;
+		std::vector<Step>				steps;
+		std::vector<Step>				dropped;
+		QString						nameSearch;
+		QString						loreSearch;
+		quint32						candidates = 0u;
+		quint32						threads = 1u;
+		
+		inline static bool				Equal(const HexBitset<Number>&, const HexBitset<Number>&);
+		
+		inline double					keepAll(const HexBitset<Number>&) const;
+		inline double					keepAny(const HexBitset<Number>&) const;
+		inline double					keepNone(const HexBitset<Number>&) const;
+		inline void					planAnyOf(const HexBitset<Number>&, const HexBitset<Number>&, const std::vector<HexBitset<Number>>&);
+		inline void					planBits(Kind, const HexBitset<Number>&);
+		template<typename Function, typename Cancelled, typename Publish> inline void	retain(HexBitmap&, Function, Cancelled, Publish*) const;
+	
+	public:
+	
+		inline						HexQueryPlanner(const HexBitmapIndex<Number>&);
+		
+		inline static quint32				Chunks(quint32);
+		
+		template<typename Function> inline QString	explain(Function) const;
+		inline const std::vector<Step>&			getSteps(void) const;
+		inline void					plan(const HexQuery<Number>&);
+		template<typename NameTest, typename LoreTest> inline HexBitmap	run(HexBitmap, NameTest, LoreTest);
+		template<typename NameTest, typename LoreTest, typename Cancelled, typename Publish> inline HexBitmap	run(HexBitmap, NameTest, LoreTest, Cancelled, Publish);
+		inline void					setThreads(quint32);
+};
+
+template<quint32 Number>
+HexQueryPlanner<Number>::HexQueryPlanner(const HexBitmapIndex<Number>& index) : bitmapIndex(index)
+{
+}
+
+// A chunk is not sized to any cache: one bitmap word already covers some 170 KiB of spell lore. It is the smallest share a worker can own, which leaves 40 chunks of spells to balance over the threads.
+template<quint32 Number>
+quint32 HexQueryPlanner<Number>::Chunks(quint32 words)
+{
+	return (words + HexQueryPlanner::ChunkWords - 1u)/HexQueryPlanner::ChunkWords;
+}
+
+template<quint32 Number>
+bool HexQueryPlanner<Number>::Equal(const HexBitset<Number>& a, const HexBitset<Number>& b)
+{
+	return (a.all(b) and b.all(a));
+}
+
+template<quint32 Number>
+template<typename Function>
+QString HexQueryPlanner<Number>::explain(Function label) const
+{
+	const auto describe = [&label, this](const Step& step)
+	{
+		auto labels = QStringList();
+		HexBitmapIndex<Number>::ForEachBit(step.bits, [&labels, &label](quint32 bit) { labels.push_back(label(bit)); });
+		
+		switch (step.kind)
+		{
+			case Kind::Require:
+				return "require " + labels.join(", ") + (step.rows ? " (row scan)" : "");
+			
+			case Kind::Exclude:
+				return "exclude " + labels.join(", ") + (step.rows ? " (row scan)" : "");
+			
+			case Kind::AnyOf:
+				return (labels.isEmpty() ? QString("any of nothing") : "any of " + labels.join(", ")) + (step.rows ? " (row scan)" : "");
+			
+			case Kind::Name:
+				return "name test \"" + HexQueryPlanner::nameSearch + "\"";
+			
+			case Kind::Lore:
+				return "lore test \"" + HexQueryPlanner::loreSearch + "\"";
+		}
+		
+		return QString();
+	};
+	
+	auto lines = QStringList("Plan over " + QString::number(HexQueryPlanner::candidates) + " candidate(s):");
+	auto position = 1;
+	
+	for (const auto& step : HexQueryPlanner::steps)
+	{
+		auto line = QString::number(position++) + ". " + describe(step) + ": est. -" + QString::number(step.estimatedRemoved);
+		
+		if (step.executed)
+			line += ", actual -" + QString::number(step.actualRemoved) + ", " + QString::number(step.left) + " left";
+		else
+			line += ", skipped";
+		
+		lines.push_back(line);
+	}
+	
+	for (const auto& step : HexQueryPlanner::dropped)
+		lines.push_back("Dropped " + describe(step) + " (" + step.reason + ")");
+	
+	return lines.join('\n');
+}
+
+template<quint32 Number>
+const std::vector<typename HexQueryPlanner<Number>::Step>& HexQueryPlanner<Number>::getSteps(void) const
+{
+	return HexQueryPlanner::steps;
+}
+
+// Flags are assumed independent, which is enough to rank the steps against each other.
+template<quint32 Number>
+double HexQueryPlanner<Number>::keepAll(const HexBitset<Number>& bits) const
+{
+	const auto records = static_cast<double>(std::max(HexQueryPlanner::bitmapIndex.size(), 1u));
+	auto result = 1.0;
+	
+	HexBitmapIndex<Number>::ForEachBit(bits, [&result, records, this](quint32 bit) { result *= HexQueryPlanner::bitmapIndex.frequency(bit)/records; });
+	return result;
+}
+
+template<quint32 Number>
+double HexQueryPlanner<Number>::keepAny(const HexBitset<Number>& bits) const
+{
+	const auto records = static_cast<double>(std::max(HexQueryPlanner::bitmapIndex.size(), 1u));
+	auto result = 1.0;
+	
+	HexBitmapIndex<Number>::ForEachBit(bits, [&result, records, this](quint32 bit) { result *= 1.0 - HexQueryPlanner::bitmapIndex.frequency(bit)/records; });
+	return 1.0 - result;
+}
+
+template<quint32 Number>
+double HexQueryPlanner<Number>::keepNone(const HexBitset<Number>& bits) const
+{
+	return 1.0 - HexQueryPlanner::keepAny(bits);
+}
+
+template<quint32 Number>
+void HexQueryPlanner<Number>::plan(const HexQuery<Number>& query)
+{
+	HexQueryPlanner::steps.clear();
+	HexQueryPlanner::dropped.clear();
+	HexQueryPlanner::nameSearch = query.nameSearch;
+	HexQueryPlanner::loreSearch = query.loreSearch;
+	
+	HexQueryPlanner::planBits(Kind::Require, query.greenBitset);
+	HexQueryPlanner::planBits(Kind::Exclude, query.redBitset);
+	HexQueryPlanner::planAnyOf(query.greenBitset, query.redBitset, query.yellowBitsets);
+	
+	// Every bitmap step costs about the same, so the one expected to remove the most records goes first.
+	std::stable_sort(HexQueryPlanner::steps.begin(), HexQueryPlanner::steps.end(), [](const Step& a, const Step& b) { return a.keep < b.keep; });
+	
+	if (not query.nameSearch.isEmpty())
+		HexQueryPlanner::steps.push_back({ Kind::Name, HexBitset<Number>(), false, HexQueryPlanner::TextKeep });
+	
+	if (not query.loreSearch.isEmpty())
+		HexQueryPlanner::steps.push_back({ Kind::Lore, HexBitset<Number>(), false, HexQueryPlanner::TextKeep });
+}
+
+// Red flags can never satisfy a yellow group, a group holding a green flag or a flag every record has is always satisfied, and a group containing another one is implied by it.
+template<quint32 Number>
+void HexQueryPlanner<Number>::planAnyOf(const HexBitset<Number>& greenBitset, const HexBitset<Number>& redBitset, const std::vector<HexBitset<Number>>& yellowBitsets)
+{
+	const auto records = HexQueryPlanner::bitmapIndex.size();
+	auto groups = std::vector<HexBitset<Number>>();
+	
+	for (const auto& yellowBitset : yellowBitsets)
+	{
+		auto group = HexBitset<Number>();
+		auto universal = false;
+		
+		HexBitmapIndex<Number>::ForEachBit(yellowBitset, [&group, &universal, &redBitset, records, this](quint32 bit)
+		{
+			if (redBitset.testBit(bit))
+				return;
+			
+			group.setBit(bit);
+			
+			if (HexQueryPlanner::bitmapIndex.frequency(bit) == records)
+				universal = true;
+		});
+		
+		if (group.any(greenBitset))
+			HexQueryPlanner::dropped.push_back({ Kind::AnyOf, yellowBitset, false, 1.0, 0u, 0u, 0u, false, "implied by a required flag" });
+		else if (universal)
+			HexQueryPlanner::dropped.push_back({ Kind::AnyOf, yellowBitset, false, 1.0, 0u, 0u, 0u, false, "every record matches" });
+		else
+			groups.push_back(group);
+	}
+	
+	for (auto i = 0u; i < groups.size(); ++i)
+	{
+		auto implied = false;
+		
+		for (auto j = 0u; j < groups.size() and not implied; ++j)
+		{
+			if (i != j and groups[i].all(groups[j]))
+				implied = (j < i or not HexQueryPlanner::Equal(groups[i], groups[j]));
+		}
+		
+		if (implied)
+			HexQueryPlanner::dropped.push_back({ Kind::AnyOf, groups[i], false, 1.0, 0u, 0u, 0u, false, "implied by a narrower group" });
+		else
+			HexQueryPlanner::steps.push_back({ Kind::AnyOf, groups[i], HexQueryPlanner::bitmapIndex.prefersRows(groups[i]), HexQueryPlanner::keepAny(groups[i]) });
+	}
+}
+
+// One step per flag, so that each can be ranked on its own, unless there are enough flags for a single row scan to be cheaper.
+template<quint32 Number>
+void HexQueryPlanner<Number>::planBits(Kind kind, const HexBitset<Number>& bitset)
+{
+	const auto records = HexQueryPlanner::bitmapIndex.size();
+	auto useful = HexBitset<Number>();
+	
+	HexBitmapIndex<Number>::ForEachBit(bitset, [&useful, kind, records, this](quint32 bit)
+	{
+		const auto frequency = HexQueryPlanner::bitmapIndex.frequency(bit);
+		auto single = HexBitset<Number>();
+		single.setBit(bit);
+		
+		if (kind == Kind::Require and frequency == records)
+			HexQueryPlanner::dropped.push_back({ kind, single, false, 1.0, 0u, 0u, 0u, false, "every record has it" });
+		else if (kind == Kind::Exclude and frequency == 0u)
+			HexQueryPlanner::dropped.push_back({ kind, single, false, 1.0, 0u, 0u, 0u, false, "no record has it" });
+		else
+			useful.setBit(bit);
+	});
+	
+	const auto keep = (kind == Kind::Require ? HexQueryPlanner::keepAll(useful) : HexQueryPlanner::keepNone(useful));
+	
+	if (HexQueryPlanner::bitmapIndex.prefersRows(useful))
+	{
+		HexQueryPlanner::steps.push_back({ kind, useful, true, keep });
+		return;
+	}
+	
+	HexBitmapIndex<Number>::ForEachBit(useful, [kind, this](quint32 bit)
+	{
+		auto single = HexBitset<Number>();
+		single.setBit(bit);
+		
+		HexQueryPlanner::steps.push_back({ kind, single, false, (kind == Kind::Require ? HexQueryPlanner::keepAll(single) : HexQueryPlanner::keepNone(single)) });
+	});
+}
+
+// Text tests are the only expensive steps. Each worker owns whole words of the bitmap, so the surviving records come out in the same order whatever the number of threads.
+// Once a chunk has passed the last text test its records are final and handed to the publisher. A cancelled run leaves its chunks untouched.
+template<quint32 Number>
+template<typename Function, typename Cancelled, typename Publish>
+void HexQueryPlanner<Number>::retain(HexBitmap& result, Function function, Cancelled cancelled, Publish* publish) const
+{
+	const auto words = result.wordCount();
+	
+	HexParallel::For(HexQueryPlanner::Chunks(words), HexQueryPlanner::threads, [&result, &function, &cancelled, publish, words](quint32 chunk)
+	{
+		if (cancelled())
+			return;
+		
+		const auto first = chunk*HexQueryPlanner::ChunkWords;
+		const auto last = std::min(first + HexQueryPlanner::ChunkWords, words);
+		
+		result.retain(function, first, last);
+		
+		if (publish != nullptr)
+			(*publish)(chunk, static_cast<const HexBitmap&>(result), first, last);
+	});
+}
+
+// Runs the plan over the starting candidates. The name and lore tests are only called on records every bitmap step kept.
+template<quint32 Number>
+template<typename NameTest, typename LoreTest>
+HexBitmap HexQueryPlanner<Number>::run(HexBitmap result, NameTest nameTest, LoreTest loreTest)
+{
+	const auto never = [](void) { return false; };
+	const auto ignore = [](quint32, const HexBitmap&, quint32, quint32) {};
+	
+	return HexQueryPlanner::run(std::move(result), nameTest, loreTest, never, ignore);
+}
+
+// The publisher receives every chunk of the final bitmap exactly once, in no particular order, possibly from several threads.
+// After a cancellation the run stops between chunks and the returned bitmap is meaningless.
+template<quint32 Number>
+template<typename NameTest, typename LoreTest, typename Cancelled, typename Publish>
+HexBitmap HexQueryPlanner<Number>::run(HexBitmap result, NameTest nameTest, LoreTest loreTest, Cancelled cancelled, Publish publish)
+{
+	HexQueryPlanner::candidates = result.count();
+	
+	auto estimate = static_cast<double>(HexQueryPlanner::candidates);
+	auto left = HexQueryPlanner::candidates;
+	auto published = false;
+	
+	for (auto& step : HexQueryPlanner::steps)
+	{
+		step.estimatedRemoved = static_cast<quint32>(estimate*(1.0 - step.keep) + 0.5);
+		estimate *= step.keep;
+		
+		if (left == 0u or cancelled())
+			continue;
+		
+		// The plan always ends with its text steps, so the last step of the plan is the last one to touch a chunk.
+		const auto lastStep = (&step == &HexQueryPlanner::steps.back());
+		
+		switch (step.kind)
+		{
+			case Kind::Require:
+			{
+				if (step.rows)
+					result.intersect(HexQueryPlanner::bitmapIndex.filter(HexPredicate::All, step.bits));
+				else
+					HexBitmapIndex<Number>::ForEachBit(step.bits, [&result, this](quint32 bit) { result.intersect(HexQueryPlanner::bitmapIndex.column(bit)); });
+				
+				break;
+			}
+			
+			case Kind::Exclude:
+			{
+				if (step.rows)
+					result.intersect(HexQueryPlanner::bitmapIndex.filter(HexPredicate::None, step.bits));
+				else
+					HexBitmapIndex<Number>::ForEachBit(step.bits, [&result, this](quint32 bit) { result.subtract(HexQueryPlanner::bitmapIndex.column(bit)); });
+				
+				break;
+			}
+			
+			case Kind::AnyOf:
+			{
+				if (step.rows)
+					result.intersect(HexQueryPlanner::bitmapIndex.filter(HexPredicate::Any, step.bits));
+				else
+				{
+					auto group = HexBitmap(result.size(), false);
+					
+					HexBitmapIndex<Number>::ForEachBit(step.bits, [&group, this](quint32 bit) { group.unite(HexQueryPlanner::bitmapIndex.column(bit)); });
+					result.intersect(group);
+				}
+				
+				break;
+			}
+			
+			case Kind::Name:
+			{
+				HexQueryPlanner::retain(result, nameTest, cancelled, (lastStep ? &publish : nullptr));
+				published = lastStep;
+				break;
+			}
+			
+			case Kind::Lore:
+			{
+				HexQueryPlanner::retain(result, loreTest, cancelled, (lastStep ? &publish : nullptr));
+				published = lastStep;
+				break;
+			}
+		}
+		
+		const auto count = result.count();
+		
+		step.executed = true;
+		step.actualRemoved = left - count;
+		step.left = count;
+		left = count;
+	}
+	
+	if (not published and not cancelled())
+	{
+		const auto words = result.wordCount();
+		
+		for (auto chunk = 0u; chunk < HexQueryPlanner::Chunks(words); ++chunk)
+		{
+			const auto first = chunk*HexQueryPlanner::ChunkWords;
+			publish(chunk, static_cast<const HexBitmap&>(result), first, std::min(first + HexQueryPlanner::ChunkWords, words));
+		}
+	}
+	
+	return result;
+}
+
+template<quint32 Number>
+void HexQueryPlanner<Number>::setThreads(quint32 count)
+{
+	HexQueryPlanner::threads = std::max(count, 1u);
+}
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef __HEX_SEARCH_HPP__
+#define __HEX_SEARCH_HPP__
+
+// Custom Libraries
+#include "HexBitmap.hpp"
+#include "HexDatabase.hpp"
+#include "HexQuery.hpp"
+#include "HexQueryPlanner.hpp"
+
+// One planned search of a database, with no widget involved: the windows stream its chunks to their list, dnd-query times it.
+class HexSearch
+{
+	public:
+	
+		template<quint32 Number, typename Cancelled, typename Publish> inline static HexBitmap	Run(const HexDatabase<Number>&, const HexQuery<Number>&, HexQueryPlanner<Number>&, HexBitmap, Cancelled, Publish);
+};
+
+// Indexes answer a text test for every record at once. Only a substring search without the suffix array tests the lore record by record.
+template<quint32 Number, typename Cancelled, typename Publish>
+HexBitmap HexSearch::Run(const HexDatabase<Number>& database, const HexQuery<Number>& query, HexQueryPlanner<Number>& planner, HexBitmap candidates, Cancelled cancelled, Publish publish)
+{
+	const auto indexedLore = (not query.loreSearch.isEmpty() and database.indexesLore(query.wordSearch));
+	
+	const auto names = (query.nameSearch.isEmpty() ? HexBitmap() : database.getNameIndex().match(query.nameSearch));
+	const auto lores = (indexedLore ? database.matchLore(query.loreSearch, query.wordSearch) : HexBitmap());
+	
+	// The class levels come straight from their index, ahead of the plan.
+	if (not query.classSearch.isEmpty())
+		candidates.intersect(database.getClassIndex().match(query.classSearch));
+	
+	const auto nameTest = [&names, &query](quint32 index) { return names.testBit(index) != query.barNames; };
+	const auto loreTest = [&database, &query, &lores, indexedLore](quint32 index)
+	{
+		if (indexedLore)
+			return (lores.testBit(index) != query.barTexts);
+		
+		return (database.containsLore(index, query.loreSearch) != query.barTexts);
+	};
+	
+	return planner.run(std::move(candidates), nameTest, loreTest, cancelled, publish);
+}
+
+#endif
@@ -0,0 +1,176 @@
+#ifndef __HEX_SUFFIX_INDEX_HPP__
+#define __HEX_SUFFIX_INDEX_HPP__
+
+// C++ Libraries
+#include <algorithm>
+#include <vector>
+
+// Qt Libraries
+#include <QString>
+#include <QStringView>
+
+// Custom Libraries
+#include "HexBitmap.hpp"
+
+// Suffix array over the lowered lore of every record, stored back to back, with the offset where each record starts.
+// Every occurrence of a pattern is the prefix of a run of consecutive suffixes, found with two binary searches, so any fragment is found, even across words.
+class HexSuffixIndex
+{
+	private:
+	
+		QString					corpus;
+		std::vector<qsizetype>			offsets;
+		std::vector<quint32>			suffixes;
+		
+		inline qsizetype			bound(QStringView, bool) const;
+	
+	public:
+	
+		inline void				build(const QString&, const std::vector<qsizetype>&);
+		inline bool				isBuilt(void) const;
+		inline HexBitmap			match(const QString&) const;
+		inline qsizetype			memory(void) const;
+};
+
+// Index of the first suffix whose beginning is not below the pattern or, with upper, is above it.
+qsizetype HexSuffixIndex::bound(QStringView pattern, bool upper) const
+{
+	const auto corpusView = QStringView(HexSuffixIndex::corpus);
+	auto low = qsizetype(0);
+	auto high = static_cast<qsizetype>(HexSuffixIndex::suffixes.size());
+	
+	while (low < high)
+	{
+		const auto middle = low + (high - low)/2;
+		const auto suffix = corpusView.sliced(HexSuffixIndex::suffixes[static_cast<std::size_t>(middle)]);
+		const auto prefix = suffix.left(pattern.size());
+		
+		const auto before = (upper ? std::lexicographical_compare(pattern.cbegin(), pattern.cend(), prefix.cbegin(), prefix.cend(), [](QChar a, QChar b) { return a.unicode() < b.unicode(); })
+			: std::lexicographical_compare(prefix.cbegin(), prefix.cend(), pattern.cbegin(), pattern.cend(), [](QChar a, QChar b) { return a.unicode() < b.unicode(); }));
+		
+		if (before != upper)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	
+	return low;
+}
+
+// Prefix doubling: after the round of length k, suffixes are sorted by their first 2k characters, each round being two counting sorts.
+// It stops as soon as every suffix has its own rank, that is after log2 of the longest repeated fragment rounds.
+void HexSuffixIndex::build(const QString& text, const std::vector<qsizetype>& starts)
+{
+	HexSuffixIndex::corpus = text;
+	HexSuffixIndex::offsets = starts;
+	
+	const auto n = static_cast<std::size_t>(text.size());
+	auto& sa = HexSuffixIndex::suffixes;
+	
+	sa.assign(n, 0u);
+	
+	if (n == 0u)
+		return;
+	
+	auto rank = std::vector<quint32>(n);
+	auto next = std::vector<quint32>(n);
+	auto count = std::vector<quint32>(std::max<std::size_t>(n, 65536u) + 1u);
+	
+	for (auto i = std::size_t(0u); i < n; ++i)
+	{
+		rank[i] = text[static_cast<qsizetype>(i)].unicode();
+		++count[rank[i] + 1u];
+	}
+	
+	for (auto c = std::size_t(1u); c < count.size(); ++c)
+		count[c] += count[c - 1u];
+	
+	for (auto i = std::size_t(0u); i < n; ++i)
+		sa[count[rank[i]]++] = static_cast<quint32>(i);
+	
+	// Ranks of the first character, numbered densely.
+	next[sa[0]] = 0u;
+	
+	for (auto i = std::size_t(1u); i < n; ++i)
+		next[sa[i]] = next[sa[i - 1u]] + (rank[sa[i]] != rank[sa[i - 1u]] ? 1u : 0u);
+	
+	std::swap(rank, next);
+	
+	for (auto k = std::size_t(1u); rank[sa[n - 1u]] + 1u < n; k <<= 1u)
+	{
+		// By second key: suffixes too short to have one come first, then the others in the order of their second half.
+		auto p = std::size_t(0u);
+		
+		for (auto i = n - std::min(k, n); i < n; ++i)
+			next[p++] = static_cast<quint32>(i);
+		
+		for (auto i = std::size_t(0u); i < n; ++i)
+		{
+			if (sa[i] >= k)
+				next[p++] = static_cast<quint32>(sa[i] - k);
+		}
+		
+		// Stable by first key.
+		const auto classes = static_cast<std::size_t>(rank[sa[n - 1u]]) + 1u;
+		std::fill(count.begin(), count.begin() + static_cast<std::ptrdiff_t>(classes + 1u), 0u);
+		
+		for (auto i = std::size_t(0u); i < n; ++i)
+			++count[rank[i] + 1u];
+		
+		for (auto c = std::size_t(1u); c <= classes; ++c)
+			count[c] += count[c - 1u];
+		
+		for (auto i = std::size_t(0u); i < n; ++i)
+			sa[count[rank[next[i]]]++] = next[i];
+		
+		const auto second = [&rank, n, k](quint32 i) { return (i + k < n ? static_cast<qint64>(rank[i + k]) : -1ll); };
+		
+		next[sa[0]] = 0u;
+		
+		for (auto i = std::size_t(1u); i < n; ++i)
+		{
+			const auto changed = (rank[sa[i]] != rank[sa[i - 1u]] or second(sa[i]) != second(sa[i - 1u]));
+			next[sa[i]] = next[sa[i - 1u]] + (changed ? 1u : 0u);
+		}
+		
+		std::swap(rank, next);
+	}
+}
+
+bool HexSuffixIndex::isBuilt(void) const
+{
+	return (not HexSuffixIndex::offsets.empty());
+}
+
+// Records whose lore contains the lowered pattern. An occurrence running past the end of its record is not one.
+HexBitmap HexSuffixIndex::match(const QString& pattern) const
+{
+	const auto records = static_cast<quint32>(HexSuffixIndex::offsets.size() - 1u);
+	auto result = HexBitmap(records, false);
+	
+	if (pattern.isEmpty())
+		return HexBitmap(records, true);
+	
+	const auto first = HexSuffixIndex::bound(pattern, false);
+	const auto last = HexSuffixIndex::bound(pattern, true);
+	
+	for (auto i = first; i < last; ++i)
+	{
+		const auto position = static_cast<qsizetype>(HexSuffixIndex::suffixes[static_cast<std::size_t>(i)]);
+		const auto it = std::upper_bound(HexSuffixIndex::offsets.cbegin(), HexSuffixIndex::offsets.cend(), position);
+		const auto record = static_cast<quint32>(it - HexSuffixIndex::offsets.cbegin() - 1);
+		
+		if (position + pattern.size() <= *it)
+			result.setBit(record);
+	}
+	
+	return result;
+}
+
+// The corpus is shared with the lore store and not counted.
+qsizetype HexSuffixIndex::memory(void) const
+{
+	return static_cast<qsizetype>(HexSuffixIndex::suffixes.capacity()*sizeof(quint32) + HexSuffixIndex::offsets.capacity()*sizeof(qsizetype));
+}
+
+#endif
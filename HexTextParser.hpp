@@ -0,0 +1,133 @@
+#ifndef __HEX_TEXT_PARSER_HPP__
+#define __HEX_TEXT_PARSER_HPP__
+
+// C++ Libraries
+#include <bit>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Qt Libraries
+#include <QByteArrayView>
+
+struct HexRecordView
+{
+	QByteArrayView		name;
+	QByteArrayView		bits;
+	QByteArrayView		info;
+	QByteArrayView		lore;
+	
+	qint32			infoPositionInFile = -1;
+	qint32			textPositionInFile = -1;
+};
+
+// Walks a whole '@'-delimited database file held in memory. Every field is a view into that buffer.
+class HexTextParser
+{
+	private:
+	
+		const char* const					begin;
+		const char* const					end;
+		const char*						cursor;
+		
+		template<char... Delimiters> inline static const char*	Find(const char*, const char*);
+		template<char Delimiter> inline QByteArrayView		extract(void);
+	
+	public:
+	
+		inline							HexTextParser(QByteArrayView);
+		
+		template<char Delimiter> inline static std::vector<QByteArrayView>	Split(QByteArrayView);
+		
+		inline bool						atEnd(void) const;
+		inline HexRecordView					next(void);
+};
+
+HexTextParser::HexTextParser(QByteArrayView text) : begin(text.data()), end(text.data() + text.size()), cursor(text.data())
+{
+}
+
+bool HexTextParser::atEnd(void) const
+{
+	return (HexTextParser::cursor == HexTextParser::end);
+}
+
+template<char Delimiter>
+QByteArrayView HexTextParser::extract(void)
+{
+	const auto start = HexTextParser::cursor;
+	const auto stop = HexTextParser::Find<Delimiter>(start, HexTextParser::end);
+	
+	HexTextParser::cursor = (stop == HexTextParser::end ? stop : stop + 1);
+	return QByteArrayView(start, stop);
+}
+
+template<char... Delimiters>
+const char* HexTextParser::Find(const char* it, const char* stop)
+{
+#if defined(__SSE2__)
+	while (stop - it >= 16)
+	{
+		const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+		auto hits = _mm_setzero_si128();
+		
+		((hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, _mm_set1_epi8(Delimiters)))), ...);
+		
+		const auto mask = static_cast<quint32>(_mm_movemask_epi8(hits));
+		
+		if (mask != 0u)
+			return it + std::countr_zero(mask);
+		
+		it += 16;
+	}
+#endif
+
+	while (it != stop and ((*it != Delimiters) and ...))
+		++it;
+	
+	return it;
+}
+
+HexRecordView HexTextParser::next(void)
+{
+	auto record = HexRecordView();
+	
+	record.name = HexTextParser::extract<'@'>();
+	record.bits = HexTextParser::extract<'@'>();
+	
+	record.infoPositionInFile = static_cast<qint32>(HexTextParser::cursor - HexTextParser::begin);
+	record.info = HexTextParser::extract<'@'>();
+	
+	record.textPositionInFile = static_cast<qint32>(HexTextParser::cursor - HexTextParser::begin);
+	record.lore = HexTextParser::extract<'\n'>();
+	
+	if (not record.lore.isEmpty() and record.lore.back() == '\r')
+		record.lore = record.lore.chopped(1);
+	
+	return record;
+}
+
+template<char Delimiter>
+std::vector<QByteArrayView> HexTextParser::Split(QByteArrayView text)
+{
+	auto fields = std::vector<QByteArrayView>();
+	auto it = text.data();
+	const auto stop = text.data() + text.size();
+	
+	while (true)
+	{
+		const auto next = HexTextParser::Find<Delimiter>(it, stop);
+		fields.emplace_back(it, next);
+		
+		if (next == stop)
+			break;
+		
+		it = next + 1;
+	}
+	
+	return fields;
+}
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef __HEX_TOP_K_HPP__
+#define __HEX_TOP_K_HPP__
+
+// C++ Libraries
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// Qt Libraries
+#include <QtGlobal>
+
+// The k best scored records seen so far, in a heap whose top is the worst of them.
+// A record only has to beat that one to get in, so n records cost O(n log k) and only the survivors are sorted.
+class HexTopK
+{
+	private:
+	
+		std::vector<std::pair<double, quint32>>	heap;
+		std::size_t				capacity;
+		
+		// Equal scores keep the file order.
+		inline static bool			Better(const std::pair<double, quint32>&, const std::pair<double, quint32>&);
+	
+	public:
+	
+		inline					HexTopK(std::size_t);
+		
+		inline void				push(double, quint32);
+		inline std::vector<std::pair<double, quint32>>	take(void);
+};
+
+HexTopK::HexTopK(std::size_t k) : capacity(k)
+{
+	HexTopK::heap.reserve(k);
+}
+
+bool HexTopK::Better(const std::pair<double, quint32>& a, const std::pair<double, quint32>& b)
+{
+	return (a.first != b.first ? a.first > b.first : a.second < b.second);
+}
+
+void HexTopK::push(double score, quint32 index)
+{
+	const auto entry = std::make_pair(score, index);
+	
+	if (HexTopK::heap.size() < HexTopK::capacity)
+	{
+		HexTopK::heap.push_back(entry);
+		std::push_heap(HexTopK::heap.begin(), HexTopK::heap.end(), HexTopK::Better);
+	}
+	else if (HexTopK::capacity != 0u and HexTopK::Better(entry, HexTopK::heap.front()))
+	{
+		std::pop_heap(HexTopK::heap.begin(), HexTopK::heap.end(), HexTopK::Better);
+		HexTopK::heap.back() = entry;
+		std::push_heap(HexTopK::heap.begin(), HexTopK::heap.end(), HexTopK::Better);
+	}
+}
+
+// Best first, and only once: the heap is moved out.
+std::vector<std::pair<double, quint32>> HexTopK::take(void)
+{
+	std::sort_heap(HexTopK::heap.begin(), HexTopK::heap.end(), HexTopK::Better);
+	return std::move(HexTopK::heap);
+}
+
+#endif
@@ -0,0 +1,79 @@
+// C++ Libraries
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// Qt Libraries
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+
+// Custom Libraries
+#include "HexMatcher.hpp"
+
+static constexpr auto Rounds = 5;
+
+// Nanoseconds per line for a search over every line, and how many lines matched.
+template<typename Function>
+static double Time(const std::vector<QString>& lines, Function function, quint32& hits)
+{
+	auto timer = QElapsedTimer();
+	timer.start();
+	
+	for (auto round = 0; round < Rounds; ++round)
+	{
+		hits = 0u;
+		
+		for (const auto& line : lines)
+		{
+			if (function(line))
+				++hits;
+		}
+	}
+	
+	return static_cast<double>(timer.nsecsElapsed())/static_cast<double>(Rounds)/static_cast<double>(lines.size());
+}
+
+int main(int argc, char** argv)
+{
+	const auto path = QString(argc > 1 ? argv[1] : "files/spells.txt");
+	auto file = QFile(path);
+	
+	if (not file.open(QIODevice::ReadOnly))
+	{
+		std::cerr << "Cannot read " << path.toStdString() << "." << std::endl;
+		return 1;
+	}
+	
+	auto lines = std::vector<QString>();
+	
+	while (not file.atEnd())
+		lines.push_back(QString::fromUtf8(file.readLine()));
+	
+	const auto patterns = std::vector<QString>({ "e", "fire", "ray of", "saving throw", "you can", "creature within", "cône", "zzzz" });
+	auto mismatches = 0u;
+	
+	std::cout << lines.size() << " lines of " << path.toStdString() << ", " << HexMatcher::InstructionSet() << " kernels, ns per line." << std::endl;
+	std::cout << std::left << std::setw(18) << "pattern" << std::setw(10) << "hits" << std::setw(18) << "indexOf(ci)" << std::setw(18) << "toLower+contains" << "HexMatcher" << std::endl;
+	
+	for (const auto& pattern : patterns)
+	{
+		auto generic = 0u;
+		auto lowered = 0u;
+		auto matcher = 0u;
+		
+		const auto a = Time(lines, [&pattern](const QString& line) { return line.indexOf(pattern, 0, Qt::CaseInsensitive) >= 0; }, generic);
+		const auto b = Time(lines, [&pattern](const QString& line) { return line.toLower().contains(pattern); }, lowered);
+		const auto c = Time(lines, [&pattern](const QString& line) { return HexMatcher::Contains(line, pattern); }, matcher);
+		
+		if (generic != matcher or lowered != matcher)
+			++mismatches;
+		
+		std::cout << std::setw(18) << ("\"" + pattern.toStdString() + "\"") << std::setw(10) << matcher << std::fixed << std::setprecision(1) << std::setw(18) << a << std::setw(18) << b << c << std::endl;
+	}
+	
+	if (mismatches != 0u)
+		std::cerr << mismatches << " patterns found a different number of lines." << std::endl;
+	
+	return (mismatches == 0u ? 0 : 1);
+}
@@ -10,6 +10,7 @@
 // Custom Libraries
 #include "Enum.hpp"
 #include "HexBitset.hpp"
+#include "HexFile.hpp"
 
 struct HexFamily
 {
@@ -36,18 +37,4 @@ struct HexFamily
 	}
 };
 
-template<quint32 Number>
-struct HexFile
-{
-	QString			name = "";
-	HexBitset<Number>	bits;
-	
-	qint32			infoPositionInFile = -1;
-	qint32			textPositionInFile = -1;
-	
-	HexFile(const QString& n, const QString& b, qint32 ip, qint32 tp) : name(n), bits(b), infoPositionInFile(ip), textPositionInFile(tp)
-	{
-	}
-};
-
 #endif
@@ -2,12 +2,19 @@
 #define __Q_ABSTRACT_DATABASE_WINDOW_HPP__
 
 // C++ Libraries
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
 #include <vector>
 
 // Qt Libraries
-#include <QFile>
+#include <QFuture>
 #include <QGridLayout>
+#include <QGroupBox>
 #include <QHash>
 #include <QLabel>
 #include <QLineEdit>
@@ -15,10 +22,22 @@
 #include <QMainWindow>
 #include <QMap>
 #include <QPushButton>
+#include <QShortcut>
+#include <QStringList>
 #include <QTextBrowser>
-#include <QTextStream>
+#include <QtConcurrent>
 
 // Custom Libraries
+#include "HexBatchQueue.hpp"
+#include "HexBitmapIndex.hpp"
+#include "HexLruCache.hpp"
+#include "HexMatcher.hpp"
+#include "HexNameTree.hpp"
+#include "HexParallel.hpp"
+#include "HexQuery.hpp"
+#include "HexQueryLanguage.hpp"
+#include "HexQueryPlanner.hpp"
+#include "HexSearch.hpp"
 #include "OtherClasses.hpp"
 
 class QAbstractDatabaseWindow : public QMainWindow
@@ -27,6 +46,60 @@ class QAbstractDatabaseWindow : public QMainWindow
 	
 	protected:
 	
+		// Records of one chunk of a running search, or the end of the search when last is set. A ranked search sends the score of each record too.
+		struct SearchBatch
+		{
+			quint32								ticket;
+			quint32								chunk;
+			std::vector<quint32>						indices;
+			std::vector<double>						scores;
+			bool								last;
+		};
+		
+		// What a search does with the list shown: replace it, keep the matches among it, or add the matches to it or remove them from it.
+		enum class ListMode
+		{
+			Replace,
+			Keep,
+			Add,
+			Remove
+		};
+		
+		// A record as shown without highlight, with where each visible character of its description lands in it, so that any highlight can be laid over it.
+		struct RenderedLore
+		{
+			QString								html;
+			QString								visible;
+			std::vector<quint32>						where;
+		};
+		
+		// A match of a search over every database, with the name of the database it comes from. Only a description search by words gives a score.
+		struct FederatedResult
+		{
+			QString								source;
+			quint32								index;
+			double								score;
+			QString								name;
+		};
+		
+		// What a database keeps from one search to the next: the results of its recent queries, the last one finished, and the one running.
+		template<quint32 Number>
+		struct SearchState
+		{
+			using ResultCache = HexLruCache<HexQuery<Number>, std::vector<quint32>, typename HexQuery<Number>::Hash>;
+			
+			ResultCache							resultCache = ResultCache(QAbstractDatabaseWindow::ResultCacheSize);
+			quint32								cacheGeneration = 0u;
+			std::optional<HexQuery<Number>>					lastQuery;
+			std::shared_ptr<HexQueryPlanner<Number>>			runningPlanner;
+			HexQuery<Number>						runningQuery;
+			ListMode							runningListMode = ListMode::Replace;
+		};
+		
+		static constexpr std::size_t						RankedResults = 100u;
+		static constexpr std::size_t						ResultCacheSize = 32u;
+		static constexpr std::size_t						LoreCacheSize = 64u;
+		
 		static const QString							FixStart;
 		static const QString							FixEnd;
 		static const QString							HighlightStart;
@@ -34,90 +107,158 @@ class QAbstractDatabaseWindow : public QMainWindow
 		
 		static QHash<QString, QAbstractDatabaseWindow*>				Databases;
 		
+		inline static void							CollectLabels(const HexFamily&, QHash<quint32, QString>&);
+		inline static std::vector<quint32>					CollectWords(const HexFamily&, quint32, HexQueryLanguage&);
 		template<typename Type> inline static QString				ConstructFromIterators(Type, Type);
-		inline static bool							Correlate(const QString&, const QString&);
-		inline static QString							ExtractString(QFile&, char);
+		template<quint32 Number> inline static void				FamilyColumn(const HexFamily&, const HexBitmapIndex<Number>&, HexBitmap&);
+		inline static QString							Highlight(const RenderedLore&, const QString&);
 		inline static QString							MakeList(const std::vector<QString>&);
 		inline static QString							MakeTable(const std::vector<QString>&, quint32);
-		inline static QString							Process(const QString&, const QString&);
+		inline static void							Process(const QString&, RenderedLore&);
 		inline static void							RemakeWidget(QWidget*, const QString&);
+		template<quint32 Number> inline static std::vector<FederatedResult>	SearchText(const HexDatabase<Number>&, const QString&, const QString&, const QString&, bool, const std::function<bool(void)>&);
+		inline static quint32							Tolerance(const QString&);
 		
-		QWidget* const								mainWidget = new QWidget();
+		const QString								databaseName;
+		QWidget*								mainWidget = nullptr;
 		
-		QMainWindow* const							informationWindow = new QMainWindow(mainWidget);
-		QTextBrowser* const							informationContent = new QTextBrowser(informationWindow);
+		QMainWindow*								informationWindow = nullptr;
+		QTextBrowser*								informationContent = nullptr;
 		
-		QPushButton* const							barNamesButton = new QPushButton("Bar Names", mainWidget);
-		QPushButton* const							barTextsButton = new QPushButton("Bar Texts", mainWidget);
-		QPushButton* const							keepListButton = new QPushButton("Keep List", mainWidget);
-		QPushButton* const							resetButton = new QPushButton("Reset Buttons", mainWidget);
+		QPushButton*								barNamesButton = nullptr;
+		QPushButton*								barTextsButton = nullptr;
+		QPushButton*								keepListButton = nullptr;
+		QPushButton*								addListButton = nullptr;
+		QPushButton*								removeListButton = nullptr;
+		QPushButton*								liveSearchButton = nullptr;
+		QPushButton*								rankButton = nullptr;
+		QPushButton*								resetButton = nullptr;
+		QPushButton*								searchAllButton = nullptr;
+		QPushButton*								wordSearchButton = nullptr;
 		
-		QLineEdit* const							nameLineEdit = new QLineEdit(mainWidget);
-		QLineEdit* const							loreLineEdit = new QLineEdit(mainWidget);
-		QListWidget* const							resultList = new QListWidget(mainWidget);
+		QLineEdit*								nameLineEdit = nullptr;
+		QLineEdit*								loreLineEdit = nullptr;
+		QLineEdit*								classLineEdit = nullptr;
+		QLineEdit*								queryLineEdit = nullptr;
+		QListWidget*								resultList = nullptr;
 		
-		QTextBrowser* const							loreBrowser = new QTextBrowser(mainWidget);
-		QLabel* const								resultLabel = new QLabel(mainWidget);
+		QTextBrowser*								loreBrowser = nullptr;
+		QLabel*									resultLabel = nullptr;
 		
 		QMap<QString, quint32>							nameToIndex;
+		HexNameTree<quint32>							nameTree;
 		std::vector<HexFamily>							buttonGroups;
 		std::vector<quint32>							searchResults;
+		HexBitmap								keptList;
+		QHash<quint32, QString>							bitLabels;
+		HexQueryLanguage							queryLanguage;
+		QHash<const QPushButton*, QString>					buttonTexts;
+		HexLruCache<quint32, RenderedLore>					loreCache = HexLruCache<quint32, RenderedLore>(LoreCacheSize);
+		quint32									loreGeneration = 0u;
+		
+		QFuture<bool>								dataFuture;
+		bool									widgetsInitialised = false;
 		
+		HexBatchQueue<SearchBatch>						batchQueue;
+		std::atomic<quint32>							searchTicket = 0u;
+		std::atomic<bool>							drainQueued = false;
+		std::vector<QFuture<void>>						searchFutures;
+		std::map<quint32, SearchBatch>						pendingBatches;
+		std::vector<quint32>							streamedResults;
+		quint32									streamedChunks = 0u;
+		
+		virtual void								addResult(quint32) = 0;
+		inline quint32								beginSearch(void);
+		inline QString								bitLabel(quint32);
+		inline void								buildNameTree(void);
+		inline void								cancelSearch(void);
+		inline void								closeDatabase(void);
+		inline void								collectLabels(void);
+		inline void								combineList(ListMode, quint32);
+		template<quint32 Number> inline void					endSearch(const HexDatabase<Number>&, SearchState<Number>&);
+		virtual void								finishSearch(void) = 0;
+		virtual void								initialiseWidgets(void) = 0;
+		inline void								initialiseInterface(void);
 		inline void								initialiseWindow(const HexFamily&, const QFont&, qint32);
+		inline bool								hasData(void) const;
+		inline HexBitmap							keptRecords(quint32) const;
+		inline ListMode								listMode(void) const;
+		virtual QListWidgetItem*						makeItem(quint32) const = 0;
+		inline void								publishBatch(SearchBatch&&);
+		template<quint32 Number> inline void					publishRanked(const HexDatabase<Number>&, const QString&, const HexBitmap&, quint32);
+		template<quint32 Number> inline bool					readQuery(HexQuery<Number>&);
+		virtual bool								renderLore(quint32, RenderedLore&) = 0;
 		inline void								resetGroup(const HexFamily&) const;
-		virtual void								updateLore(quint32, QTextBrowser*) = 0;
+		template<quint32 Number> inline void					runSearch(const HexDatabase<Number>&, SearchState<Number>&, const HexQuery<Number>&);
+		virtual std::vector<FederatedResult>					searchText(const QString&, const QString&, bool, const std::function<bool(void)>&) const = 0;
+		inline void								showEvent(QShowEvent*) override;
+		template<quint32 Number> inline void					showFacets(const HexBitmapIndex<Number>&);
+		template<quint32 Number> inline void					showFacets(const HexFamily&, const HexBitmapIndex<Number>&, const HexBitmap&, quint32);
+		inline void								showFederated(quint32, const std::vector<FederatedResult>&, const QStringList&);
+		inline void								showLore(quint32, quint32, QTextBrowser*, const QString&);
+		inline void								showScore(double);
+		inline QString								suggestions(void) const;
+		virtual void								updateLore(quint32, QTextBrowser*, const QString&) = 0;
+		inline void								waitForData(void);
+	
+	signals:
+	
+		void									batchQueued(void);
 	
 	protected slots:
 	
+		inline void								applySuggestion(const QString&);
+		inline void								drainBatches(void);
+		inline void								liveSearch(void);
 		inline void								resetButtons(void) const;
 		virtual void								search(void) = 0;
+		inline void								searchAll(void);
 		inline void 								showDescriptionFromClick(const QUrl&);
 		inline void 								showDescriptionFromList(QListWidgetItem*);
 		inline void 								switchButtonState(void) const;
+		inline void								switchListMode(void) const;
 	
 	public:
 	
 		inline									QAbstractDatabaseWindow(QWidget*, const QString&);
 };
 
-QAbstractDatabaseWindow::QAbstractDatabaseWindow(QWidget* foo, const QString& name) : QMainWindow(foo)
+// Registers the database with the others; its widgets wait for the window to be shown.
+QAbstractDatabaseWindow::QAbstractDatabaseWindow(QWidget* foo, const QString& name) : QMainWindow(foo), databaseName(name)
 {
 	QAbstractDatabaseWindow::Databases[name] = this;
-	QMainWindow::setCentralWidget(QAbstractDatabaseWindow::mainWidget);
-	
 	QAbstractDatabaseWindow::buttonGroups.reserve(20u);
 	
-	QAbstractDatabaseWindow::nameLineEdit->setPlaceholderText("Search names...");
-	QAbstractDatabaseWindow::loreLineEdit->setPlaceholderText("Search descriptions...");
-	
-	QAbstractDatabaseWindow::loreBrowser->setReadOnly(true);
-	QAbstractDatabaseWindow::loreBrowser->setOpenLinks(false);
-	
-	const auto someWidget = new QWidget();
-	const auto layout = new QVBoxLayout();
+	QObject::connect(this, SIGNAL(batchQueued(void)), this, SLOT(drainBatches(void)), Qt::QueuedConnection);
+}
+
+void QAbstractDatabaseWindow::CollectLabels(const HexFamily& fml, QHash<quint32, QString>& labels)
+{
+	if (fml.masterButton != nullptr and fml.bit != compl(0u))
+		labels[fml.bit] = fml.masterButton->text();
 	
-	QAbstractDatabaseWindow::informationWindow->setCentralWidget(someWidget);
-	layout->addWidget(QAbstractDatabaseWindow::informationContent);
-	someWidget->setLayout(layout);
+	for (const auto& child : fml.familyGroups)
+		QAbstractDatabaseWindow::CollectLabels(child, labels);
+}
+
+// Files every label under the family in the group and gives the flags it stands for: all those of its window for a button opening one.
+std::vector<quint32> QAbstractDatabaseWindow::CollectWords(const HexFamily& fml, quint32 group, HexQueryLanguage& language)
+{
+	auto bits = std::vector<quint32>();
 	
-	QAbstractDatabaseWindow::informationWindow->setWindowTitle("Information Window");
-	QAbstractDatabaseWindow::informationWindow->resize(600, 800);
+	if (fml.bit != compl(0u))
+		bits.push_back(fml.bit);
 	
-	const auto flags = QAbstractDatabaseWindow::informationWindow->windowFlags();
-	QAbstractDatabaseWindow::informationWindow->setWindowFlags(flags | Qt::WindowStaysOnTopHint);
-	
-	QAbstractDatabaseWindow::informationContent->setReadOnly(true);
-	QAbstractDatabaseWindow::informationContent->setOpenLinks(false);
+	for (const auto& child : fml.familyGroups)
+	{
+		const auto childBits = QAbstractDatabaseWindow::CollectWords(child, group, language);
+		bits.insert(bits.end(), childBits.cbegin(), childBits.cend());
+	}
 	
-	QObject::connect(QAbstractDatabaseWindow::resetButton, SIGNAL(released(void)), this, SLOT(resetButtons(void)));
-	QObject::connect(QAbstractDatabaseWindow::resultList, SIGNAL(currentItemChanged(QListWidgetItem*, QListWidgetItem*)), this, SLOT(showDescriptionFromList(QListWidgetItem*)));
-	QObject::connect(QAbstractDatabaseWindow::loreBrowser, SIGNAL(anchorClicked(const QUrl&)), this, SLOT(showDescriptionFromClick(const QUrl&)));
-	QObject::connect(QAbstractDatabaseWindow::informationContent, SIGNAL(anchorClicked(const QUrl&)), this, SLOT(showDescriptionFromClick(const QUrl&)));
+	if (fml.masterButton != nullptr)
+		language.addEntry(group, fml.masterButton->text(), bits);
 	
-	//QString stylesheet = "table, td { border: 1px solid #333; }"
-	//			"thead, tfoot { background-color: #333; color: #fff; }";
-	//
-	//QAbstractDatabaseWindow::loreBrowser->document()->setDefaultStyleSheet(stylesheet);
+	return bits;
 }
 
 template<typename Type>
@@ -134,61 +275,283 @@ QString QAbstractDatabaseWindow::ConstructFromIterators(Type it, Type end)
 	return foo;
 }
 
-bool QAbstractDatabaseWindow::Correlate(const QString& str1, const QString& str2)
+// A name offered by the result label replaces the one typed.
+void QAbstractDatabaseWindow::applySuggestion(const QString& name)
 {
-	const auto size1 = str1.size();
-	const auto size2 = str2.size();
+	QAbstractDatabaseWindow::nameLineEdit->setText(name);
+	this->search();
+}
+
+// A new ticket cancels whatever search was running: its workers notice the change between chunks, and its late batches are ignored.
+quint32 QAbstractDatabaseWindow::beginSearch(void)
+{
+	const auto ticket = ++QAbstractDatabaseWindow::searchTicket;
 	
-	if (size2 > size1 and size2 - size1 >= 3u)
-		return false;
+	std::erase_if(QAbstractDatabaseWindow::searchFutures, [](const QFuture<void>& future) { return future.isFinished(); });
 	
-	if (size1 > size2 and size1 - size2 >= 3u)
-		return false;
+	QAbstractDatabaseWindow::pendingBatches.clear();
+	QAbstractDatabaseWindow::streamedResults.clear();
+	QAbstractDatabaseWindow::streamedChunks = 0u;
 	
-	auto it1 = str1.cbegin();
-	auto it2 = str2.cbegin();
-	auto count = 0;
+	QAbstractDatabaseWindow::resultList->clear();
+	QAbstractDatabaseWindow::resultLabel->setText("Searching...");
+	
+	return ticket;
+}
+
+QString QAbstractDatabaseWindow::bitLabel(quint32 bit)
+{
+	QAbstractDatabaseWindow::collectLabels();
+	return QAbstractDatabaseWindow::bitLabels.value(bit, "flag " + QString::number(bit));
+}
+
+// Part of the load, on the thread pool: the tree is only read once the data future has finished.
+void QAbstractDatabaseWindow::buildNameTree(void)
+{
+	QAbstractDatabaseWindow::nameTree.clear();
 	
-	while (count < size1 and count < size2 and it1->toLower() == it2->toLower())
+	for (auto it = QAbstractDatabaseWindow::nameToIndex.cbegin(); QAbstractDatabaseWindow::nameToIndex.cend() != it; ++it)
+		QAbstractDatabaseWindow::nameTree.insert(it.key(), it.value());
+}
+
+// The labels of the flags and the words of the query language, read from the buttons once the widgets exist, and before any count is written on them.
+void QAbstractDatabaseWindow::collectLabels(void)
+{
+	if (QAbstractDatabaseWindow::bitLabels.isEmpty())
 	{
-		++count;
-		++it1;
-		++it2;
+		for (const auto& fml : QAbstractDatabaseWindow::buttonGroups)
+			QAbstractDatabaseWindow::CollectLabels(fml, QAbstractDatabaseWindow::bitLabels);
 	}
 	
-	if (count == size1 and count == size2)
-		return true;
+	if (QAbstractDatabaseWindow::queryLanguage.isEmpty())
+	{
+		for (const auto& fml : QAbstractDatabaseWindow::buttonGroups)
+		{
+			const auto box = (fml.familyGroups.empty() ? nullptr : qobject_cast<QGroupBox*>(fml.familyGroups.front().masterButton->parentWidget()));
+			
+			if (box != nullptr)
+				QAbstractDatabaseWindow::CollectWords(fml, QAbstractDatabaseWindow::queryLanguage.addGroup(box->title()), QAbstractDatabaseWindow::queryLanguage);
+		}
+	}
+}
+
+// The list shown once a search is over: its results, or the previous list with them added or removed. Its bitmap is kept for the next search, which combines with it without rebuilding it.
+void QAbstractDatabaseWindow::combineList(ListMode mode, quint32 records)
+{
+	auto list = HexBitmap::FromIndices(QAbstractDatabaseWindow::searchResults, records);
 	
-	if (count <= 1 or size1 == size2)
-		return false;
+	if (mode == ListMode::Add or mode == ListMode::Remove)
+	{
+		auto kept = QAbstractDatabaseWindow::keptRecords(records);
+		
+		if (mode == ListMode::Add)
+			kept.unite(list);
+		else
+			kept.subtract(list);
+		
+		list = std::move(kept);
+		QAbstractDatabaseWindow::searchResults = list.toIndices();
+		QAbstractDatabaseWindow::resultList->clear();
+		
+		for (const auto index : QAbstractDatabaseWindow::searchResults)
+			this->addResult(index);
+	}
 	
-	auto itt1 = str1.crbegin();
-	auto itt2 = str2.crbegin();
+	QAbstractDatabaseWindow::keptList = std::move(list);
 	
-	while (count < size1 and count < size2 and itt1->toLower() == itt2->toLower())
+	// The list shows the results of this window again, after a search over every database.
+	for (const auto button : { QAbstractDatabaseWindow::keepListButton, QAbstractDatabaseWindow::addListButton, QAbstractDatabaseWindow::removeListButton })
+		button->setEnabled(true);
+}
+
+// The workers read the derived database, so the derived destructor has to call this.
+void QAbstractDatabaseWindow::cancelSearch(void)
+{
+	++QAbstractDatabaseWindow::searchTicket;
+	
+	for (const auto& future : QAbstractDatabaseWindow::searchFutures)
+		future.waitForFinished();
+	
+	QAbstractDatabaseWindow::searchFutures.clear();
+}
+
+// First thing the destructor of a database does: the load and every search, of this window or over every database, read its records.
+void QAbstractDatabaseWindow::closeDatabase(void)
+{
+	QAbstractDatabaseWindow::Databases.remove(QAbstractDatabaseWindow::databaseName);
+	
+	for (const auto& db : QAbstractDatabaseWindow::Databases)
+		db->cancelSearch();
+	
+	QAbstractDatabaseWindow::cancelSearch();
+	QAbstractDatabaseWindow::dataFuture.waitForFinished();
+}
+
+// The end of a search of either database, once its last batch is shown: the plan as a tooltip, the cache, and the list.
+template<quint32 Number>
+void QAbstractDatabaseWindow::endSearch(const HexDatabase<Number>& database, SearchState<Number>& state)
+{
+	if (state.runningPlanner != nullptr)
 	{
-		++count;
-		++itt1;
-		++itt2;
+		QAbstractDatabaseWindow::resultLabel->setToolTip(state.runningPlanner->explain([this](quint32 bit) { return QAbstractDatabaseWindow::bitLabel(bit); }));
+		
+		// Ranked results are cut to the best few and their scores are not kept, so they are not cached either.
+		if (state.runningListMode == ListMode::Replace and not state.runningQuery.ranked)
+			state.resultCache.insert(state.runningQuery, QAbstractDatabaseWindow::searchResults);
+		
+		state.runningPlanner.reset();
 	}
 	
-	return (size1 == count or size2 == count);
+	// After a list search, the results no longer cover everything the query matches.
+	if (state.runningListMode != ListMode::Replace)
+		state.lastQuery.reset();
+	else
+		state.lastQuery = state.runningQuery;
+	
+	QAbstractDatabaseWindow::combineList(state.runningListMode, database.getIndex().size());
+	
+	const auto size = QAbstractDatabaseWindow::searchResults.size();
+	const auto resultString = QString::number(size) + " result" + QString(size > 1u ? "s" : "") + ".";
+	
+	QAbstractDatabaseWindow::resultLabel->setText(size == 0u ? resultString + QAbstractDatabaseWindow::suggestions() : resultString);
+	QAbstractDatabaseWindow::showFacets(database.getIndex());
 }
 
-QString QAbstractDatabaseWindow::ExtractString(QFile& file, char stopChar)
+// Chunks finish in any order. Only those following the last one shown can be appended, the others wait in pendingBatches.
+void QAbstractDatabaseWindow::drainBatches(void)
 {
-	auto result = QString();
-	auto newChar = '0';
+	QAbstractDatabaseWindow::drainQueued = false;
 	
-	while (file.getChar(&newChar))
+	const auto ticket = QAbstractDatabaseWindow::searchTicket.load();
+	auto finished = false;
+	
+	for (auto& batch : QAbstractDatabaseWindow::batchQueue.takeAll())
 	{
-		if (newChar == stopChar)
-			break;
+		if (batch.ticket != ticket)
+			continue;
 		
-		result += newChar;
+		if (batch.last)
+			finished = true;
+		else
+			QAbstractDatabaseWindow::pendingBatches.emplace(batch.chunk, std::move(batch));
 	}
 	
-	return result;
+	auto it = QAbstractDatabaseWindow::pendingBatches.begin();
+	
+	while (QAbstractDatabaseWindow::pendingBatches.end() != it and it->first == QAbstractDatabaseWindow::streamedChunks)
+	{
+		const auto& batch = it->second;
+		
+		for (auto i = std::size_t(0u); i < batch.indices.size(); ++i)
+		{
+			this->addResult(batch.indices[i]);
+			QAbstractDatabaseWindow::streamedResults.push_back(batch.indices[i]);
+			
+			if (not batch.scores.empty())
+				QAbstractDatabaseWindow::showScore(batch.scores[i]);
+		}
+		
+		it = QAbstractDatabaseWindow::pendingBatches.erase(it);
+		++QAbstractDatabaseWindow::streamedChunks;
+	}
+	
+	// Every chunk is queued before the end of the search, so nothing can be pending any more.
+	if (finished)
+	{
+		QAbstractDatabaseWindow::searchResults = std::move(QAbstractDatabaseWindow::streamedResults);
+		QAbstractDatabaseWindow::streamedResults.clear();
+		this->finishSearch();
+	}
+	else
+	{
+		const auto size = QAbstractDatabaseWindow::streamedResults.size();
+		QAbstractDatabaseWindow::resultLabel->setText("Searching... " + QString::number(size) + " result" + QString(size > 1u ? "s" : "") + " so far.");
+	}
+}
+
+// The widgets every database shares, built the first time the window is shown, before those of the database.
+void QAbstractDatabaseWindow::initialiseInterface(void)
+{
+	QAbstractDatabaseWindow::mainWidget = new QWidget();
+	
+	QAbstractDatabaseWindow::informationWindow = new QMainWindow(QAbstractDatabaseWindow::mainWidget);
+	QAbstractDatabaseWindow::informationContent = new QTextBrowser(QAbstractDatabaseWindow::informationWindow);
+	
+	QAbstractDatabaseWindow::barNamesButton = new QPushButton("Bar Names", QAbstractDatabaseWindow::mainWidget);
+	QAbstractDatabaseWindow::barTextsButton = new QPushButton("Bar Texts", QAbstractDatabaseWindow::mainWidget);
+	QAbstractDatabaseWindow::keepListButton = new QPushButton("Keep List", QAbstractDatabaseWindow::mainWidget);
+	QAbstractDatabaseWindow::addListButton = new QPushButton("Add to List", QAbstractDatabaseWindow::mainWidget);
+	QAbstractDatabaseWindow::removeListButton = new QPushButton("Remove from List", QAbstractDatabaseWindow::mainWidget);
+	QAbstractDatabaseWindow::liveSearchButton = new QPushButton("Live Search", QAbstractDatabaseWindow::mainWidget);
+	QAbstractDatabaseWindow::rankButton = new QPushButton("Rank Results", QAbstractDatabaseWindow::mainWidget);
+	QAbstractDatabaseWindow::resetButton = new QPushButton("Reset Buttons", QAbstractDatabaseWindow::mainWidget);
+	QAbstractDatabaseWindow::searchAllButton = new QPushButton("Search All Databases", QAbstractDatabaseWindow::mainWidget);
+	QAbstractDatabaseWindow::wordSearchButton = new QPushButton("Word Search", QAbstractDatabaseWindow::mainWidget);
+	
+	QAbstractDatabaseWindow::nameLineEdit = new QLineEdit(QAbstractDatabaseWindow::mainWidget);
+	QAbstractDatabaseWindow::loreLineEdit = new QLineEdit(QAbstractDatabaseWindow::mainWidget);
+	QAbstractDatabaseWindow::classLineEdit = new QLineEdit(QAbstractDatabaseWindow::mainWidget);
+	QAbstractDatabaseWindow::queryLineEdit = new QLineEdit(QAbstractDatabaseWindow::mainWidget);
+	QAbstractDatabaseWindow::resultList = new QListWidget(QAbstractDatabaseWindow::mainWidget);
+	
+	QAbstractDatabaseWindow::loreBrowser = new QTextBrowser(QAbstractDatabaseWindow::mainWidget);
+	QAbstractDatabaseWindow::resultLabel = new QLabel(QAbstractDatabaseWindow::mainWidget);
+	
+	QMainWindow::setCentralWidget(QAbstractDatabaseWindow::mainWidget);
+	
+	QAbstractDatabaseWindow::nameLineEdit->setPlaceholderText("Search names...");
+	QAbstractDatabaseWindow::loreLineEdit->setPlaceholderText("Search descriptions...");
+	QAbstractDatabaseWindow::classLineEdit->setPlaceholderText("Class levels, such as Cleric <= 3, Wizard 2..4...");
+	QAbstractDatabaseWindow::queryLineEdit->setPlaceholderText("Query, such as level:1..3 -descriptor:fire lore:\"ray\"...");
+	
+	QAbstractDatabaseWindow::rankButton->setToolTip("With Word Search on, order description matches by relevance (BM25, names count double) and keep the best " + QString::number(QAbstractDatabaseWindow::RankedResults) + ".");
+	QAbstractDatabaseWindow::keepListButton->setToolTip("Search among the results shown only.");
+	QAbstractDatabaseWindow::addListButton->setToolTip("Add the records matching the search to the results shown.");
+	QAbstractDatabaseWindow::removeListButton->setToolTip("Remove the records matching the search from the results shown.");
+	QAbstractDatabaseWindow::wordSearchButton->setToolTip("Search descriptions by whole words: \"exact phrase\", OR, NOT or -word, (groups).");
+	QAbstractDatabaseWindow::searchAllButton->setToolTip("Search the name and description of every database at once (Ctrl+Return); buttons are ignored.");
+	
+	QAbstractDatabaseWindow::loreBrowser->setReadOnly(true);
+	QAbstractDatabaseWindow::loreBrowser->setOpenLinks(false);
+	
+	const auto someWidget = new QWidget();
+	const auto layout = new QVBoxLayout();
+	
+	QAbstractDatabaseWindow::informationWindow->setCentralWidget(someWidget);
+	layout->addWidget(QAbstractDatabaseWindow::informationContent);
+	someWidget->setLayout(layout);
+	
+	QAbstractDatabaseWindow::informationWindow->setWindowTitle("Information Window");
+	QAbstractDatabaseWindow::informationWindow->resize(600, 800);
+	
+	const auto flags = QAbstractDatabaseWindow::informationWindow->windowFlags();
+	QAbstractDatabaseWindow::informationWindow->setWindowFlags(flags | Qt::WindowStaysOnTopHint);
+	
+	QAbstractDatabaseWindow::informationContent->setReadOnly(true);
+	QAbstractDatabaseWindow::informationContent->setOpenLinks(false);
+	
+	const auto searchAllShortcut = new QShortcut(QAbstractDatabaseWindow::mainWidget);
+	searchAllShortcut->setKeys({ QKeySequence(Qt::CTRL | Qt::Key_Return), QKeySequence(Qt::CTRL | Qt::Key_Enter) });
+	
+	QObject::connect(QAbstractDatabaseWindow::resetButton, SIGNAL(released(void)), this, SLOT(resetButtons(void)));
+	QObject::connect(QAbstractDatabaseWindow::searchAllButton, SIGNAL(released(void)), this, SLOT(searchAll(void)));
+	QObject::connect(searchAllShortcut, SIGNAL(activated(void)), this, SLOT(searchAll(void)));
+	QObject::connect(QAbstractDatabaseWindow::keepListButton, SIGNAL(toggled(bool)), this, SLOT(switchListMode(void)));
+	QObject::connect(QAbstractDatabaseWindow::addListButton, SIGNAL(toggled(bool)), this, SLOT(switchListMode(void)));
+	QObject::connect(QAbstractDatabaseWindow::removeListButton, SIGNAL(toggled(bool)), this, SLOT(switchListMode(void)));
+	QObject::connect(QAbstractDatabaseWindow::nameLineEdit, SIGNAL(textEdited(const QString&)), this, SLOT(liveSearch(void)));
+	QObject::connect(QAbstractDatabaseWindow::loreLineEdit, SIGNAL(textEdited(const QString&)), this, SLOT(liveSearch(void)));
+	QObject::connect(QAbstractDatabaseWindow::classLineEdit, SIGNAL(textEdited(const QString&)), this, SLOT(liveSearch(void)));
+	QObject::connect(QAbstractDatabaseWindow::queryLineEdit, SIGNAL(textEdited(const QString&)), this, SLOT(liveSearch(void)));
+	QObject::connect(QAbstractDatabaseWindow::resultList, SIGNAL(currentItemChanged(QListWidgetItem*, QListWidgetItem*)), this, SLOT(showDescriptionFromList(QListWidgetItem*)));
+	QObject::connect(QAbstractDatabaseWindow::loreBrowser, SIGNAL(anchorClicked(const QUrl&)), this, SLOT(showDescriptionFromClick(const QUrl&)));
+	QObject::connect(QAbstractDatabaseWindow::informationContent, SIGNAL(anchorClicked(const QUrl&)), this, SLOT(showDescriptionFromClick(const QUrl&)));
+	QObject::connect(QAbstractDatabaseWindow::resultLabel, SIGNAL(linkActivated(const QString&)), this, SLOT(applySuggestion(const QString&)));
+	
+	//QString stylesheet = "table, td { border: 1px solid #333; }"
+	//			"thead, tfoot { background-color: #333; color: #fff; }";
+	//
+	//QAbstractDatabaseWindow::loreBrowser->document()->setDefaultStyleSheet(stylesheet);
 }
 
 void QAbstractDatabaseWindow::initialiseWindow(const HexFamily& fml, const QFont& font, qint32 columns)
@@ -217,6 +580,45 @@ void QAbstractDatabaseWindow::initialiseWindow(const HexFamily& fml, const QFont
 	window->hide();
 }
 
+// Records carrying a flag of the family, added to the bitmap.
+template<quint32 Number>
+void QAbstractDatabaseWindow::FamilyColumn(const HexFamily& fml, const HexBitmapIndex<Number>& index, HexBitmap& bitmap)
+{
+	if (fml.bit != compl(0u))
+		bitmap.unite(index.column(fml.bit));
+	
+	for (const auto& child : fml.familyGroups)
+		QAbstractDatabaseWindow::FamilyColumn(child, index, bitmap);
+}
+
+// The highlight is searched among the visible characters of the record, so one render serves every pattern typed.
+QString QAbstractDatabaseWindow::Highlight(const RenderedLore& rendered, const QString& pattern)
+{
+	if (pattern.isEmpty())
+		return rendered.html;
+	
+	// Matches do not overlap. One running across markup wraps the markup too.
+	auto highlighted = QString();
+	highlighted.reserve(rendered.html.size() + 16);
+	
+	auto copied = qsizetype(0);
+	
+	for (auto found = HexMatcher::IndexOf(rendered.visible, pattern); found >= 0; found = HexMatcher::IndexOf(rendered.visible, pattern, found + pattern.size()))
+	{
+		const auto start = static_cast<qsizetype>(rendered.where[static_cast<std::size_t>(found)]);
+		const auto end = static_cast<qsizetype>(rendered.where[static_cast<std::size_t>(found + pattern.size() - 1)]) + 1;
+		
+		highlighted += QStringView(rendered.html).sliced(copied, start - copied);
+		highlighted += QAbstractDatabaseWindow::HighlightStart;
+		highlighted += QStringView(rendered.html).sliced(start, end - start);
+		highlighted += QAbstractDatabaseWindow::HighlightEnd;
+		copied = end;
+	}
+	
+	highlighted += QStringView(rendered.html).sliced(copied);
+	return highlighted;
+}
+
 QString QAbstractDatabaseWindow::MakeList(const std::vector<QString>& listCells)
 {
 	if (listCells.empty())
@@ -282,7 +684,8 @@ QString QAbstractDatabaseWindow::MakeTable(const std::vector<QString>& tableCell
 	return result + "</table></p>";
 }
 
-QString QAbstractDatabaseWindow::Process(const QString& lore, const QString& pattern)
+// Appends the description to the record, which holds its header so far.
+void QAbstractDatabaseWindow::Process(const QString& lore, RenderedLore& rendered)
 {
 	auto text = QString("<p align=\"justify\">");
 	text.reserve(lore.capacity()*2u);
@@ -400,15 +803,18 @@ QString QAbstractDatabaseWindow::Process(const QString& lore, const QString& pat
 		}
 	}
 	
-	const auto size = pattern.size();
-	auto it = pattern.cbegin();
+	auto& result = rendered.html;
+	result.reserve(result.size() + text.size());
 	
-	auto result = QString();
-	result.reserve(text.capacity());
+	// The visible characters, and where each of them lands in the result, for the highlight.
+	auto& visible = rendered.visible;
+	auto& where = rendered.where;
+	
+	visible.reserve(text.size());
+	where.reserve(static_cast<std::size_t>(text.size()));
 	
 	auto braces = 0u;
 	auto fixes = 0u;
-	auto pos = 0u;
 	
 	for (auto cit = text.cbegin(); cit != text.cend(); ++cit)
 	{
@@ -511,34 +917,16 @@ QString QAbstractDatabaseWindow::Process(const QString& lore, const QString& pat
 		
 			default:
 			{
-				if (size > 0u and cit->toLower() == *it)
-				{
-					if (pattern.cbegin() == it)
-						pos = result.size();
-					
-					++it;
-					
-					if (pattern.cend() == it)
-					{
-						result.insert(pos, QAbstractDatabaseWindow::HighlightStart);
-						result += *cit;
-						result += QAbstractDatabaseWindow::HighlightEnd;
-					}
-					else
-						result += *cit;
-				}
-				else
-				{
-					it = pattern.cbegin();
-					result += *cit;
-				}
+				visible += *cit;
+				where.push_back(static_cast<quint32>(result.size()));
 				
+				result += *cit;
 				break;
 			}
 		}
 	}
 	
-	return result + "</p>";
+	result += "</p>";
 }
 
 void QAbstractDatabaseWindow::RemakeWidget(QWidget* foo, const QString& name)
@@ -548,6 +936,93 @@ void QAbstractDatabaseWindow::RemakeWidget(QWidget* foo, const QString& name)
 	foo->style()->polish(foo);
 }
 
+// One shard of a search over every database: the text tests alone, planned on the calling thread. A description search by words keeps its best few, by score.
+template<quint32 Number>
+std::vector<QAbstractDatabaseWindow::FederatedResult> QAbstractDatabaseWindow::SearchText(const HexDatabase<Number>& database, const QString& source, const QString& name, const QString& lore, bool words, const std::function<bool(void)>& cancelled)
+{
+	auto query = HexQuery<Number>();
+	query.nameSearch = name;
+	query.loreSearch = lore;
+	query.wordSearch = words;
+	query.ranked = not lore.isEmpty();
+	query.normalise();
+	
+	auto planner = HexQueryPlanner<Number>(database.getIndex());
+	planner.plan(query);
+	planner.setThreads(1u);
+	
+	const auto matches = HexSearch::Run(database, query, planner, HexBitmap(database.getIndex().size(), true), cancelled, [](quint32, const HexBitmap&, quint32, quint32) {});
+	auto result = std::vector<FederatedResult>();
+	
+	if (cancelled())
+		return result;
+	
+	if (query.ranked)
+	{
+		for (const auto& [score, index] : database.rank(query.loreSearch, matches, QAbstractDatabaseWindow::RankedResults))
+			result.push_back({ source, index, score, database.getFiles()[index].name });
+	}
+	else
+		matches.forEach([&database, &source, &result](quint32 index) { result.push_back({ source, index, 0.0, database.getFiles()[index].name }); });
+	
+	return result;
+}
+
+// The records of the list shown, or none when it belongs to another version of the database.
+HexBitmap QAbstractDatabaseWindow::keptRecords(quint32 records) const
+{
+	return (QAbstractDatabaseWindow::keptList.size() == records ? QAbstractDatabaseWindow::keptList : HexBitmap(records, false));
+}
+
+QAbstractDatabaseWindow::ListMode QAbstractDatabaseWindow::listMode(void) const
+{
+	if (QAbstractDatabaseWindow::keepListButton->isChecked())
+		return ListMode::Keep;
+	
+	if (QAbstractDatabaseWindow::addListButton->isChecked())
+		return ListMode::Add;
+	
+	if (QAbstractDatabaseWindow::removeListButton->isChecked())
+		return ListMode::Remove;
+	
+	return ListMode::Replace;
+}
+
+void QAbstractDatabaseWindow::liveSearch(void)
+{
+	if (QAbstractDatabaseWindow::liveSearchButton->isChecked())
+		this->search();
+}
+
+// Called from the workers. Only the first batch after a drain raises the signal, so the event loop never piles up notifications.
+void QAbstractDatabaseWindow::publishBatch(SearchBatch&& batch)
+{
+	QAbstractDatabaseWindow::batchQueue.push(std::move(batch));
+	
+	if (not QAbstractDatabaseWindow::drainQueued.exchange(true))
+		emit QAbstractDatabaseWindow::batchQueued();
+}
+
+// Adds the typed query to the one read from the buttons. The words are those of the buttons, under the title of their box.
+template<quint32 Number>
+bool QAbstractDatabaseWindow::readQuery(HexQuery<Number>& query)
+{
+	const auto text = QAbstractDatabaseWindow::queryLineEdit->text();
+	
+	if (text.trimmed().isEmpty())
+		return true;
+	
+	QAbstractDatabaseWindow::collectLabels();
+	
+	auto error = QString();
+	
+	if (QAbstractDatabaseWindow::queryLanguage.compile(text, query, error))
+		return true;
+	
+	QAbstractDatabaseWindow::resultLabel->setText(error);
+	return false;
+}
+
 void QAbstractDatabaseWindow::resetButtons(void) const
 {
 	for (const auto& fml : QAbstractDatabaseWindow::buttonGroups)
@@ -567,7 +1042,147 @@ void QAbstractDatabaseWindow::resetGroup(const HexFamily& fml) const
 	for (const auto& foo : fml.familyGroups)
 		QAbstractDatabaseWindow::resetGroup(foo);
 }
-#include <iostream>
+
+// A search of either database, once its window has read the query: from the cache, or planned and run away from the GUI thread.
+template<quint32 Number>
+void QAbstractDatabaseWindow::runSearch(const HexDatabase<Number>& database, SearchState<Number>& state, const HexQuery<Number>& query)
+{
+	if (state.cacheGeneration != database.getGeneration())
+	{
+		state.resultCache.clear();
+		state.lastQuery.reset();
+		state.cacheGeneration = database.getGeneration();
+	}
+	
+	// A list search makes the outcome depend on the previous results, so it is never cached.
+	const auto listMode = QAbstractDatabaseWindow::listMode();
+	const auto cached = (listMode != ListMode::Replace ? nullptr : state.resultCache.find(query));
+	
+	// The candidates of a narrowing search come from the last finished one, so they are read before the list is cleared.
+	const auto& bitmapIndex = database.getIndex();
+	const auto narrowing = (state.lastQuery.has_value() and query.narrows(*state.lastQuery));
+	
+	auto candidates = (narrowing ? HexBitmap::FromIndices(QAbstractDatabaseWindow::searchResults, bitmapIndex.size()) : HexBitmap(bitmapIndex.size(), true));
+	
+	// Matches kept or removed are among the list, so the search starts from its bitmap; matches added may be anywhere.
+	if (listMode == ListMode::Keep or listMode == ListMode::Remove)
+		candidates = QAbstractDatabaseWindow::keptRecords(bitmapIndex.size());
+	
+	const auto ticket = QAbstractDatabaseWindow::beginSearch();
+	
+	state.runningQuery = query;
+	state.runningListMode = listMode;
+	state.runningPlanner.reset();
+	
+	if (cached != nullptr)
+	{
+		QAbstractDatabaseWindow::searchResults = *cached;
+		QAbstractDatabaseWindow::resultLabel->setToolTip("Served from the result cache.");
+		
+		for (const auto index : QAbstractDatabaseWindow::searchResults)
+			this->addResult(index);
+		
+		this->finishSearch();
+		return;
+	}
+	
+	const auto planner = std::make_shared<HexQueryPlanner<Number>>(bitmapIndex);
+	planner->plan(query);
+	planner->setThreads(HexParallel::Threads());
+	
+	state.runningPlanner = planner;
+	
+	// The plan runs away from the GUI thread and streams its chunks back as they are final, so typing never waits for it.
+	QAbstractDatabaseWindow::searchFutures.push_back(QtConcurrent::run([this, &database, planner, query, candidates = std::move(candidates), ticket](void) mutable
+	{
+		const auto cancelled = [this, ticket](void) { return QAbstractDatabaseWindow::searchTicket != ticket; };
+		
+		const auto publish = [this, ticket](quint32 chunk, const HexBitmap& result, quint32 first, quint32 last)
+		{
+			auto indices = std::vector<quint32>();
+			result.forEach([&indices](quint32 index) { indices.push_back(index); }, first, last);
+			
+			QAbstractDatabaseWindow::publishBatch({ ticket, chunk, std::move(indices), {}, false });
+		};
+		
+		// A ranked search holds its chunks back, since the order is only known once every record is.
+		if (query.ranked)
+		{
+			const auto result = HexSearch::Run(database, query, *planner, std::move(candidates), cancelled, [](quint32, const HexBitmap&, quint32, quint32) {});
+			
+			if (cancelled())
+				return;
+			
+			QAbstractDatabaseWindow::publishRanked(database, query.loreSearch, result, ticket);
+		}
+		else
+			HexSearch::Run(database, query, *planner, std::move(candidates), cancelled, publish);
+		
+		if (not cancelled())
+			QAbstractDatabaseWindow::publishBatch({ ticket, 0u, std::vector<quint32>(), {}, true });
+	}));
+}
+
+// Fans the name and description typed out to every database, one shard per database on the global thread pool, and shows the merged list once the slowest has answered.
+void QAbstractDatabaseWindow::searchAll(void)
+{
+	const auto name = QAbstractDatabaseWindow::nameLineEdit->text().trimmed().toLower();
+	const auto lore = QAbstractDatabaseWindow::loreLineEdit->text().trimmed().toLower();
+	
+	if (name.isEmpty() and lore.isEmpty())
+	{
+		QAbstractDatabaseWindow::resultLabel->setText("Type a name or a description to search every database.");
+		return;
+	}
+	
+	const auto words = QAbstractDatabaseWindow::wordSearchButton->isChecked();
+	const auto ticket = QAbstractDatabaseWindow::beginSearch();
+	const auto databases = QAbstractDatabaseWindow::Databases.values();
+	
+	QAbstractDatabaseWindow::resultLabel->setToolTip("Every database, searched side by side.");
+	
+	QAbstractDatabaseWindow::searchFutures.push_back(QtConcurrent::run([this, databases, name, lore, words, ticket](void)
+	{
+		const auto cancelled = std::function<bool(void)>([this, ticket](void) { return QAbstractDatabaseWindow::searchTicket != ticket; });
+		const auto count = static_cast<quint32>(databases.size());
+		auto shards = std::vector<std::vector<FederatedResult>>(count);
+		auto failed = std::vector<char>(count, false);
+		
+		// A database still loading holds its own shard only. One that could not load leaves its shard empty: exiting from a worker would pull the program down under the other threads.
+		HexParallel::For(count, count, [&databases, &shards, &failed, &name, &lore, words, &cancelled](quint32 i)
+		{
+			if (databases[i]->hasData())
+				shards[i] = databases[i]->searchText(name, lore, words, cancelled);
+			else
+				failed[i] = true;
+		});
+		
+		if (cancelled())
+			return;
+		
+		auto missing = QStringList();
+		
+		for (auto i = 0u; i < count; ++i)
+		{
+			if (failed[i])
+				missing.push_back(databases[i]->databaseName);
+		}
+		
+		auto results = std::vector<FederatedResult>();
+		
+		for (auto& shard : shards)
+			results.insert(results.end(), std::make_move_iterator(shard.begin()), std::make_move_iterator(shard.end()));
+		
+		// Best scores first, then names in order, so that a name search reads as one list.
+		std::sort(results.begin(), results.end(), [](const FederatedResult& a, const FederatedResult& b) { return (a.score != b.score ? a.score > b.score : a.name < b.name); });
+		
+		if (results.size() > QAbstractDatabaseWindow::RankedResults and words and not lore.isEmpty())
+			results.resize(QAbstractDatabaseWindow::RankedResults);
+		
+		QMetaObject::invokeMethod(this, [this, ticket, results, missing](void) { QAbstractDatabaseWindow::showFederated(ticket, results, missing); }, Qt::QueuedConnection);
+	}));
+}
+
 void QAbstractDatabaseWindow::showDescriptionFromClick(const QUrl& url)
 {
 	const auto sender = static_cast<QTextBrowser*>(QObject::sender());
@@ -576,51 +1191,55 @@ void QAbstractDatabaseWindow::showDescriptionFromClick(const QUrl& url)
 	const auto& name = sender->textCursor().selectedText();
 	const auto& descriptor = url.url();
 	
+	// A link naming its database is only looked up there; otherwise every database is.
 	const auto dit = QAbstractDatabaseWindow::Databases.find(descriptor);
+	const auto target = (QAbstractDatabaseWindow::Databases.cend() != dit ? dit.value() : nullptr);
 	
-	if (QAbstractDatabaseWindow::Databases.cend() != dit)
+	for (const auto& db : QAbstractDatabaseWindow::Databases)
 	{
-		const auto db = dit.value();
+		if (target != nullptr and target != db)
+			continue;
+		
+		db->waitForData();
 		const auto cit = db->nameToIndex.find(name);
 		
 		if (db->nameToIndex.cend() != cit)
 		{
-			db->updateLore(cit.value(), recipient);
+			db->updateLore(cit.value(), recipient, QAbstractDatabaseWindow::loreLineEdit->text().toLower());
 			QAbstractDatabaseWindow::informationWindow->show(); // Either it has to be shown, or it is visible already.
-		}
-		else
-		{
-			const auto start = name.left(3);
-			const auto stop = name.left(2) + static_cast<char>(name[2].unicode() + 1u); // name is somewhere between start and stop
-			const auto end = QAbstractDatabaseWindow::nameToIndex.upperBound(stop);
-			
-			for (auto it = QAbstractDatabaseWindow::nameToIndex.lowerBound(start); it != end; ++it)
-			{
-				const auto found = QAbstractDatabaseWindow::Correlate(it.key(), name);
-				
-				if (found)
-				{
-					this->updateLore(it.value(), recipient);
-					QAbstractDatabaseWindow::informationWindow->show(); // Same.
-					break;
-				}
-			}
+			return;
 		}
 	}
-	else
+	
+	// The text of a link may be misspelt, or inflected; the nearest name close enough stands for it. Every database searched has loaded by now.
+	const auto tolerance = QAbstractDatabaseWindow::Tolerance(name);
+	auto nearest = static_cast<QAbstractDatabaseWindow*>(nullptr);
+	auto match = HexNameTree<quint32>::Match();
+	
+	for (const auto& db : QAbstractDatabaseWindow::Databases)
 	{
-		for (const auto& db : QAbstractDatabaseWindow::Databases)
+		if (target != nullptr and target != db)
+			continue;
+		
+		const auto matches = db->nameTree.search(name, tolerance, 1u, [](quint32) { return true; });
+		
+		if (matches.empty())
+			continue;
+		
+		const auto& found = matches.front();
+		
+		if (nearest == nullptr or found.distance < match.distance or (found.distance == match.distance and found.name.toLower() < match.name.toLower()))
 		{
-			const auto cit = db->nameToIndex.find(name);
-			
-			if (db->nameToIndex.cend() != cit)
-			{
-				db->updateLore(cit.value(), recipient);
-				QAbstractDatabaseWindow::informationWindow->show(); // Same.
-				break;
-			}
+			nearest = db;
+			match = found;
 		}
 	}
+	
+	if (nearest != nullptr)
+	{
+		nearest->updateLore(match.value, recipient, QAbstractDatabaseWindow::loreLineEdit->text().toLower());
+		QAbstractDatabaseWindow::informationWindow->show(); // Same.
+	}
 }
 
 void QAbstractDatabaseWindow::showDescriptionFromList(QListWidgetItem* newItem)
@@ -628,11 +1247,179 @@ void QAbstractDatabaseWindow::showDescriptionFromList(QListWidgetItem* newItem)
 	if (newItem == nullptr)
 		return;
 	
-	const auto name = newItem->text();
-	const auto it = QAbstractDatabaseWindow::nameToIndex.find(name);
+	// An item of a search over every database names the database of its record.
+	const auto source = newItem->data(Qt::UserRole + 1).toString();
+	const auto database = (source.isEmpty() ? this : QAbstractDatabaseWindow::Databases.value(source, this));
+	
+	database->waitForData();
+	database->updateLore(newItem->data(Qt::UserRole).toUInt(), QAbstractDatabaseWindow::loreBrowser, QAbstractDatabaseWindow::loreLineEdit->text().toLower());
+}
+
+void QAbstractDatabaseWindow::showEvent(QShowEvent* e)
+{
+	if (not QAbstractDatabaseWindow::widgetsInitialised)
+	{
+		QAbstractDatabaseWindow::initialiseInterface();
+		this->initialiseWidgets();
+		QAbstractDatabaseWindow::widgetsInitialised = true;
+	}
+	
+	QMainWindow::showEvent(e);
+}
+
+// Writes on every button how many of the results shown carry its flag, whatever the state of the button; a button opening a window counts those carrying any flag of it.
+// The tooltip tells what requiring or excluding the flag would keep of these results. One popcount over a column and the results per button, so a refresh of every button costs a few microseconds per thousand records.
+template<quint32 Number>
+void QAbstractDatabaseWindow::showFacets(const HexBitmapIndex<Number>& index)
+{
+	QAbstractDatabaseWindow::collectLabels();
+	
+	const auto results = HexBitmap::FromIndices(QAbstractDatabaseWindow::searchResults, index.size());
+	const auto total = results.count();
+	
+	for (const auto& fml : QAbstractDatabaseWindow::buttonGroups)
+		QAbstractDatabaseWindow::showFacets(fml, index, results, total);
+}
+
+template<quint32 Number>
+void QAbstractDatabaseWindow::showFacets(const HexFamily& fml, const HexBitmapIndex<Number>& index, const HexBitmap& results, quint32 total)
+{
+	for (const auto& child : fml.familyGroups)
+		QAbstractDatabaseWindow::showFacets(child, index, results, total);
+	
+	if (fml.masterButton == nullptr)
+		return;
+	
+	auto count = 0u;
+	
+	if (fml.bit != compl(0u))
+		count = results.intersectionCount(index.column(fml.bit));
+	else
+	{
+		auto bitmap = HexBitmap(index.size(), false);
+		QAbstractDatabaseWindow::FamilyColumn(fml, index, bitmap);
+		count = results.intersectionCount(bitmap);
+	}
+	
+	auto it = QAbstractDatabaseWindow::buttonTexts.constFind(fml.masterButton);
+	
+	if (QAbstractDatabaseWindow::buttonTexts.cend() == it)
+		it = QAbstractDatabaseWindow::buttonTexts.insert(fml.masterButton, fml.masterButton->text());
+	
+	const auto text = it.value() + " (" + QString::number(count) + ")";
+	
+	// Setting the same text would still lay the button out again.
+	if (fml.masterButton->text() != text)
+		fml.masterButton->setText(text);
+	
+	const auto carry = (fml.bit != compl(0u) ? QString(" carry this flag") : QString(" carry a flag of this window"));
+	fml.masterButton->setToolTip(QString::number(count) + " of the " + QString::number(total) + " results shown" + carry + ": requiring it would keep " + QString::number(count) + " of them, excluding it " + QString::number(total - count) + ".");
+}
+
+// The list and label of a search over every database. The results of the last search of this window are kept for narrowing, but the list buttons would act on records no longer shown, so they wait for the next search of this window.
+void QAbstractDatabaseWindow::showFederated(quint32 ticket, const std::vector<FederatedResult>& results, const QStringList& missing)
+{
+	if (ticket != QAbstractDatabaseWindow::searchTicket)
+		return;
+	
+	for (const auto button : { QAbstractDatabaseWindow::keepListButton, QAbstractDatabaseWindow::addListButton, QAbstractDatabaseWindow::removeListButton })
+	{
+		button->setChecked(false);
+		button->setEnabled(false);
+	}
+	
+	for (const auto& result : results)
+	{
+		const auto item = QAbstractDatabaseWindow::Databases.value(result.source)->makeItem(result.index);
+		item->setText(item->text() + "  [" + result.source + "]");
+		item->setData(Qt::UserRole + 1, result.source);
+		
+		QAbstractDatabaseWindow::resultList->addItem(item);
+		
+		if (result.score > 0.0)
+			QAbstractDatabaseWindow::showScore(result.score);
+	}
+	
+	const auto size = results.size();
+	const auto searched = QAbstractDatabaseWindow::Databases.size() - missing.size();
+	const auto failure = (missing.isEmpty() ? QString() : " Could not load: " + missing.join(", ") + ".");
+	
+	QAbstractDatabaseWindow::resultLabel->setText(QString::number(size) + " result" + QString(size > 1u ? "s" : "") + " in " + QString::number(searched) + " databases." + failure);
+}
+
+// Records are rendered once and kept in the lore cache, so moving through the list only lays the highlight of the description typed over them.
+// The description is that of the window showing the record, which may be another database, whose widgets are perhaps not built.
+void QAbstractDatabaseWindow::showLore(quint32 index, quint32 generation, QTextBrowser* browser, const QString& highlight)
+{
+	if (QAbstractDatabaseWindow::loreGeneration != generation)
+	{
+		QAbstractDatabaseWindow::loreCache.clear();
+		QAbstractDatabaseWindow::loreGeneration = generation;
+	}
+	
+	auto rendered = QAbstractDatabaseWindow::loreCache.find(index);
+	
+	if (rendered == nullptr)
+	{
+		auto fresh = RenderedLore();
+		
+		if (not this->renderLore(index, fresh))
+			return;
+		
+		QAbstractDatabaseWindow::loreCache.insert(index, std::move(fresh));
+		rendered = QAbstractDatabaseWindow::loreCache.find(index);
+	}
+	
+	browser->setHtml(QAbstractDatabaseWindow::Highlight(*rendered, highlight));
+}
+
+// Appends the score to the item just added; the item keeps its record in Qt::UserRole, so its text is free.
+void QAbstractDatabaseWindow::showScore(double score)
+{
+	const auto item = QAbstractDatabaseWindow::resultList->item(QAbstractDatabaseWindow::resultList->count() - 1);
+	item->setText(item->text() + "  (" + QString::number(score, 'f', 2) + ")");
+}
+
+// The best records of a ranked search, in one batch with their scores, once every chunk has passed its tests.
+template<quint32 Number>
+void QAbstractDatabaseWindow::publishRanked(const HexDatabase<Number>& database, const QString& lore, const HexBitmap& result, quint32 ticket)
+{
+	auto batch = SearchBatch({ ticket, 0u, {}, {}, false });
+	
+	for (const auto& [score, index] : database.rank(lore, result, QAbstractDatabaseWindow::RankedResults))
+	{
+		batch.indices.push_back(index);
+		batch.scores.push_back(score);
+	}
+	
+	QAbstractDatabaseWindow::publishBatch(std::move(batch));
+}
+
+// Names of this database close to the one typed, offered as links when a search finds nothing.
+QString QAbstractDatabaseWindow::suggestions(void) const
+{
+	const auto name = QAbstractDatabaseWindow::nameLineEdit->text().trimmed();
 	
-	if (QAbstractDatabaseWindow::nameToIndex.cend() != it)
-		this->updateLore(it.value(), QAbstractDatabaseWindow::loreBrowser);
+	if (name.isEmpty())
+		return QString();
+	
+	const auto matches = QAbstractDatabaseWindow::nameTree.search(name, QAbstractDatabaseWindow::Tolerance(name), 3u, [](quint32) { return true; });
+	
+	if (matches.empty())
+		return QString();
+	
+	auto result = QString(" Did you mean ");
+	
+	for (auto i = std::size_t(0u); i < matches.size(); ++i)
+	{
+		if (i > 0u)
+			result += (i + 1u == matches.size() ? " or " : ", ");
+		
+		const auto escaped = matches[i].name.toHtmlEscaped();
+		result += "<a href=\"" + escaped + "\">" + escaped + "</a>";
+	}
+	
+	return result + "?";
 }
 
 void QAbstractDatabaseWindow::switchButtonState(void) const
@@ -669,4 +1456,38 @@ void QAbstractDatabaseWindow::switchButtonState(void) const
 	QAbstractDatabaseWindow::RemakeWidget(sender, nextName);
 }
 
+// The list buttons exclude each other.
+void QAbstractDatabaseWindow::switchListMode(void) const
+{
+	const auto sender = static_cast<QPushButton*>(QObject::sender());
+	
+	if (not sender->isChecked())
+		return;
+	
+	for (const auto button : { QAbstractDatabaseWindow::keepListButton, QAbstractDatabaseWindow::addListButton, QAbstractDatabaseWindow::removeListButton })
+	{
+		if (button != sender)
+			button->setChecked(false);
+	}
+}
+
+// Edits allowed between a name and the text standing for it: one per four characters, between one and three.
+quint32 QAbstractDatabaseWindow::Tolerance(const QString& name)
+{
+	return static_cast<quint32>(std::clamp<qsizetype>(name.size()/4, 1, 3));
+}
+
+// Waits for the load of the database, from any thread; false when it failed.
+bool QAbstractDatabaseWindow::hasData(void) const
+{
+	return QAbstractDatabaseWindow::dataFuture.result();
+}
+
+// Only for the GUI thread, which is the one that may end the program.
+void QAbstractDatabaseWindow::waitForData(void)
+{
+	if (not QAbstractDatabaseWindow::hasData())
+		std::exit(1);
+}
+
 #endif
@@ -4,9 +4,12 @@
 // Qt Libraries
 #include <QGroupBox>
 #include <QShortcut>
+#include <QtConcurrent>
 
 // Custom Libraries
 #include "HexBitsetPack.hpp"
+#include "HexDatabase.hpp"
+#include "HexSearch.hpp"
 #include "QAbstractDatabaseWindow.hpp"
 
 class QPowerDatabaseWindow : public QAbstractDatabaseWindow
@@ -24,14 +27,13 @@ class QPowerDatabaseWindow : public QAbstractDatabaseWindow
 		
 		inline static QColor				Foreground(const HexBitset<Number>&);
 		
-		std::vector<HexFile<Number>>			allPowers;
-		QFile						powerFile;
-		QTextStream					powerFileStream;
+		HexDatabase<Number>				powerDatabase;
+		SearchState<Number>				searchState;
 		
 		inline void					initialiseAreas(const QFont&, QGridLayout*);
 		inline void					initialiseClasses(const QFont&, QGridLayout*);
 		inline void					initialiseControlButtons(const QFont&, QGridLayout*);
-		inline void					initialiseData(void);
+		inline bool					initialiseData(void);
 		inline void					initialiseDescriptors(const QFont&, QGridLayout*);
 		inline void					initialiseDisciplines(const QFont&, QGridLayout*);
 		inline void					initialiseDisplays(const QFont&, QGridLayout*);
@@ -48,9 +50,7 @@ class QPowerDatabaseWindow : public QAbstractDatabaseWindow
 		inline void					initialiseSpecial(const QFont&, QGridLayout*);
 		inline void					initialiseSubdisciplines(const QFont&, QGridLayout*);
 		inline void					initialiseTargets(const QFont&, QGridLayout*);
-		inline void					initialiseWidgets(void);
 		inline void					initialiseWindow(const HexFamily&, const QFont&, qint32);
-		inline bool					powerIsValid(const HexFile<Number>&, const HexBitset<Number>&, const HexBitset<Number>&, const std::vector<HexBitset<Number>>&, const QString&, const QString&, bool, bool);
 		
 	protected slots:
 	
@@ -58,26 +58,32 @@ class QPowerDatabaseWindow : public QAbstractDatabaseWindow
 	
 	protected:
 	
+		inline void					addResult(quint32) final;
 		inline void					closeEvent(QCloseEvent*);
-		inline void					updateLore(quint32, QTextBrowser*) final;
+		inline void					finishSearch(void) final;
+		inline void					initialiseWidgets(void) final;
+		inline QListWidgetItem*				makeItem(quint32) const final;
+		inline bool					renderLore(quint32, RenderedLore&) final;
+		inline std::vector<FederatedResult>		searchText(const QString&, const QString&, bool, const std::function<bool(void)>&) const final;
+		inline void					updateLore(quint32, QTextBrowser*, const QString&) final;
 	
 	public:
 	
 		inline						QPowerDatabaseWindow(QWidget*);
+		inline						~QPowerDatabaseWindow(void);
 };
 
 QPowerDatabaseWindow::QPowerDatabaseWindow(QWidget* foo) :
 	QAbstractDatabaseWindow(foo, "power"),
-	powerFile("files/powers.txt"),
-	powerFileStream(&powerFile)
+	powerDatabase("files/powers.txt", "files/powers.hexdb", PowerClassFieldFirst, PowerClassFieldLast)
 {
-	QPowerDatabaseWindow::initialiseData();
-	QPowerDatabaseWindow::initialiseWidgets();
-	
-	const auto s1 = new QShortcut(QAbstractDatabaseWindow::mainWidget);
-	s1->setKeys({ QKeySequence(Qt::Key_Return), QKeySequence(Qt::Key_Enter) });
-	
-	QObject::connect(s1, SIGNAL(activated(void)), this, SLOT(search(void)));
+	// Only the records are loaded here, on the global thread pool; the widgets wait for the window to be shown.
+	QAbstractDatabaseWindow::dataFuture = QtConcurrent::run([this](void) { return QPowerDatabaseWindow::initialiseData(); });
+}
+
+QPowerDatabaseWindow::~QPowerDatabaseWindow(void)
+{
+	QAbstractDatabaseWindow::closeDatabase();
 }
 
 QColor QPowerDatabaseWindow::Foreground(const HexBitset<Number>& b)
@@ -173,7 +179,7 @@ void QPowerDatabaseWindow::initialiseControlButtons(const QFont& font, QGridLayo
 	const auto filterControlBox = new QGroupBox("Filter Controls", QAbstractDatabaseWindow::mainWidget);
 	const auto filterControlLayout = new QGridLayout();
 	
-	const auto buttonList = { QAbstractDatabaseWindow::barNamesButton, QAbstractDatabaseWindow::keepListButton, QAbstractDatabaseWindow::barTextsButton };
+	const auto buttonList = { QAbstractDatabaseWindow::barNamesButton, QAbstractDatabaseWindow::keepListButton, QAbstractDatabaseWindow::barTextsButton, QAbstractDatabaseWindow::liveSearchButton, QAbstractDatabaseWindow::wordSearchButton, QAbstractDatabaseWindow::rankButton, QAbstractDatabaseWindow::addListButton, QAbstractDatabaseWindow::removeListButton };
 	auto count = 0;
 	
 	for (const auto& btn : buttonList)
@@ -185,10 +191,14 @@ void QPowerDatabaseWindow::initialiseControlButtons(const QFont& font, QGridLayo
 		++count;
 	}
 	
-	filterControlLayout->addWidget(QAbstractDatabaseWindow::resetButton, 1, 1);
+	filterControlLayout->addWidget(QAbstractDatabaseWindow::resetButton, 4, 0, 1, 2);
 	QAbstractDatabaseWindow::resetButton->setObjectName("KL");
 	QAbstractDatabaseWindow::resetButton->setFont(font);
 	
+	filterControlLayout->addWidget(QAbstractDatabaseWindow::searchAllButton, 5, 0, 1, 2);
+	QAbstractDatabaseWindow::searchAllButton->setObjectName("KL");
+	QAbstractDatabaseWindow::searchAllButton->setFont(font);
+	
 	filterControlBox->setLayout(filterControlLayout);
 	layout->addWidget(filterControlBox, 9, 8, 2, 2);
 }
@@ -373,8 +383,10 @@ void QPowerDatabaseWindow::initialiseEverythingElse(QGridLayout* layout)
 {
 	layout->addWidget(QAbstractDatabaseWindow::nameLineEdit, 13, 0, 1, 5);
 	layout->addWidget(QAbstractDatabaseWindow::loreLineEdit, 13, 5, 1, 5);
+	layout->addWidget(QAbstractDatabaseWindow::classLineEdit, 14, 0, 1, 5);
+	layout->addWidget(QAbstractDatabaseWindow::queryLineEdit, 14, 5, 1, 5);
 	
-	layout->addWidget(QAbstractDatabaseWindow::resultList, 0, 10, 14, 7);
+	layout->addWidget(QAbstractDatabaseWindow::resultList, 0, 10, 15, 7);
 	layout->addWidget(QAbstractDatabaseWindow::loreBrowser, 0, 17, 13, 10);
 	layout->addWidget(QAbstractDatabaseWindow::resultLabel, 13, 17, 1, 10);
 }
@@ -739,34 +751,31 @@ void QPowerDatabaseWindow::initialiseTargets(const QFont& font, QGridLayout* lay
 	layout->addWidget(targetBox, 11, 0, 2, 3);
 }
 
+void QPowerDatabaseWindow::addResult(quint32 index)
+{
+	QAbstractDatabaseWindow::resultList->addItem(QPowerDatabaseWindow::makeItem(index));
+}
+
 void QPowerDatabaseWindow::closeEvent(QCloseEvent* e)
 {
 	QWidget::parentWidget()->show();
 	QMainWindow::closeEvent(e);
 }
 
-void QPowerDatabaseWindow::initialiseData(void)
+void QPowerDatabaseWindow::finishSearch(void)
 {
-	if (not QPowerDatabaseWindow::powerFile.open(QIODevice::ReadOnly | QIODevice::Text))
-		std::exit(1);
+	QAbstractDatabaseWindow::endSearch(QPowerDatabaseWindow::powerDatabase, QPowerDatabaseWindow::searchState);
+}
+
+bool QPowerDatabaseWindow::initialiseData(void)
+{
+	if (not QPowerDatabaseWindow::powerDatabase.load())
+		return false;
 	
-	QPowerDatabaseWindow::powerFileStream.seek(0);
-	auto line = 0u;
+	QAbstractDatabaseWindow::nameToIndex = QPowerDatabaseWindow::powerDatabase.getNameToIndex();
+	QAbstractDatabaseWindow::buildNameTree();
 	
-	while (not QPowerDatabaseWindow::powerFileStream.atEnd())
-	{
-		const auto name = QAbstractDatabaseWindow::ExtractString(QPowerDatabaseWindow::powerFile, '@');
-		const auto bset = QAbstractDatabaseWindow::ExtractString(QPowerDatabaseWindow::powerFile, '@');
-		
-		const auto infoPos = QPowerDatabaseWindow::powerFile.pos();
-		const auto info = QAbstractDatabaseWindow::ExtractString(QPowerDatabaseWindow::powerFile, '@');
-		
-		const auto lorePos = QPowerDatabaseWindow::powerFile.pos();
-		const auto lore = QAbstractDatabaseWindow::ExtractString(QPowerDatabaseWindow::powerFile, '\n');
-		
-		QPowerDatabaseWindow::allPowers.emplace_back(name, bset, infoPos, lorePos);
-		QPowerDatabaseWindow::nameToIndex[name] = line++;
-	}
+	return true;
 }
 
 void QPowerDatabaseWindow::initialiseWidgets(void)
@@ -801,127 +810,37 @@ void QPowerDatabaseWindow::initialiseWidgets(void)
 	QPowerDatabaseWindow::initialiseEverythingElse(layout);
 	
 	QAbstractDatabaseWindow::mainWidget->setLayout(layout);
-}
-
-void QPowerDatabaseWindow::search(void)
-{
-	const auto fullPack = HexBitsetPack<Number>(QAbstractDatabaseWindow::buttonGroups);
-	const auto nameSearch = QAbstractDatabaseWindow::nameLineEdit->text().toLower();
-	const auto loreSearch = QAbstractDatabaseWindow::loreLineEdit->text().toLower();
-	
-	const auto& greenBitset = fullPack.getGreenBitset();
-	const auto& redBitset = fullPack.getRedBitset();
-	const auto& yellowBitsets = fullPack.getYellowBitsets();
-	
-	const auto checkGreen = not greenBitset.null();
-	const auto checkRed = not redBitset.null();
-	
-	auto index = 0u;
-	
-	if (QAbstractDatabaseWindow::keepListButton->isChecked())
-	{
-		auto newSearchResults = std::vector<quint32>();
-		
-		for (const auto& u : QAbstractDatabaseWindow::searchResults)
-		{
-			const auto& file = QPowerDatabaseWindow::allPowers[u];
-			const auto valid = QPowerDatabaseWindow::powerIsValid(file, greenBitset, redBitset, yellowBitsets, nameSearch, loreSearch, checkGreen, checkRed);
-			
-			if (valid)
-				newSearchResults.push_back(index);
-			
-			++index;
-		}
-		
-		QAbstractDatabaseWindow::searchResults.swap(newSearchResults);
-	}
-	else
-	{
-		QAbstractDatabaseWindow::searchResults.clear();
-		
-		for (const auto& file : QPowerDatabaseWindow::allPowers)
-		{
-			const auto valid = QPowerDatabaseWindow::powerIsValid(file, greenBitset, redBitset, yellowBitsets, nameSearch, loreSearch, checkGreen, checkRed);
-			
-			if (valid)
-				QAbstractDatabaseWindow::searchResults.push_back(index);
-			
-			++index;
-		}
-	}
-	
-	QAbstractDatabaseWindow::resultList->clear();
-	
-	for (const auto& u : QPowerDatabaseWindow::searchResults)
-	{
-		const auto& file = QPowerDatabaseWindow::allPowers[u];
-		const auto item = new QListWidgetItem(file.name);
-		
-		const auto foregroundColor = QPowerDatabaseWindow::Foreground(file.bits);
-		item->setForeground(foregroundColor);
-		
-		QAbstractDatabaseWindow::resultList->addItem(item);
-	}
 	
-	const auto size = QPowerDatabaseWindow::searchResults.size();
-	const auto resultString = QString::number(size) + " result" + QString(size > 1u ? "s" : "") + ".";
+	const auto s1 = new QShortcut(QAbstractDatabaseWindow::mainWidget);
+	s1->setKeys({ QKeySequence(Qt::Key_Return), QKeySequence(Qt::Key_Enter) });
 	
-	QAbstractDatabaseWindow::resultLabel->setText(resultString);
+	QObject::connect(s1, SIGNAL(activated(void)), this, SLOT(search(void)));
 }
 
-bool QPowerDatabaseWindow::powerIsValid(const HexFile<Number>& file, const HexBitset<Number>& greenBitset, const HexBitset<Number>& redBitset, const std::vector<HexBitset<Number>>& yellowBitsets, const QString& nameSearch, const QString& loreSearch, bool checkGreen, bool checkRed)
+QListWidgetItem* QPowerDatabaseWindow::makeItem(quint32 index) const
 {
-	if (checkGreen and not file.bits.all(greenBitset))
-		return false;
-	
-	if (checkRed and not file.bits.none(redBitset))
-		return false;
+	const auto& file = QPowerDatabaseWindow::powerDatabase.getFiles()[index];
+	const auto item = new QListWidgetItem(file.name);
+	item->setData(Qt::UserRole, index);
 	
-	for (const auto& yellowBitset : yellowBitsets)
-	{
-		if (not file.bits.any(yellowBitset))
-			return false;
-	}
+	const auto foregroundColor = QPowerDatabaseWindow::Foreground(file.bits);
+	item->setForeground(foregroundColor);
 	
-	if (not nameSearch.isEmpty())
-	{
-		const auto theName = file.name.toLower();
-		
-		if (QAbstractDatabaseWindow::barNamesButton->isChecked() and theName.indexOf(nameSearch) >= 0)
-			return false;
-		
-		if (not QAbstractDatabaseWindow::barNamesButton->isChecked() and theName.indexOf(nameSearch) < 0)
-			return false;
-	}
-	
-	if (not loreSearch.isEmpty())
-	{
-		QPowerDatabaseWindow::powerFileStream.seek(file.textPositionInFile);
-		const auto theLore = QPowerDatabaseWindow::powerFileStream.readLine().toLower();
-		
-		if (QAbstractDatabaseWindow::barTextsButton->isChecked() and theLore.indexOf(loreSearch, Qt::CaseInsensitive) >= 0)
-			return false;
-		
-		if (not QAbstractDatabaseWindow::barTextsButton->isChecked() and theLore.indexOf(loreSearch, Qt::CaseInsensitive) < 0)
-			return false;
-	}
-	
-	return true;
+	return item;
 }
 
-void QPowerDatabaseWindow::updateLore(quint32 index, QTextBrowser* browser)
+// The record as shown, without highlight; false when its line does not read.
+bool QPowerDatabaseWindow::renderLore(quint32 index, RenderedLore& rendered)
 {
-	const auto& file = QPowerDatabaseWindow::allPowers[index];
-	QPowerDatabaseWindow::powerFileStream.seek(file.infoPositionInFile);
-	
-	const auto info = QAbstractDatabaseWindow::ExtractString(QPowerDatabaseWindow::powerFile, '@');
-	const auto infoList = info.split(';');
+	const auto& file = QPowerDatabaseWindow::powerDatabase.getFiles()[index];
+	const auto infoList = QPowerDatabaseWindow::powerDatabase.getInfo(index).split(';');
 	
 	if (infoList.size() != 15u)
-		return;
+		return false;
 	
-	const auto lore = QPowerDatabaseWindow::powerFileStream.readLine();
-	auto qText = "<b>" + file.name + "</b><br>" + infoList.at(0) + "<br>";
+	const auto lore = QPowerDatabaseWindow::powerDatabase.getLoreLine(index);
+	auto& qText = rendered.html;
+	qText = "<b>" + file.name + "</b><br>" + infoList.at(0) + "<br>";
 	
 	if (not infoList.at(1).isEmpty())
 		qText += "<b>Base Classes:</b> " + infoList.at(1) + "<br>";
@@ -957,9 +876,46 @@ void QPowerDatabaseWindow::updateLore(quint32 index, QTextBrowser* browser)
 		qText += "<b>Power Resistance:</b> " + infoList.at(13) + "<br>";
 	
 	qText += "<b>Source:</b> " + infoList.back();
-	qText += QAbstractDatabaseWindow::Process(lore, QAbstractDatabaseWindow::loreLineEdit->text().toLower());
+	QAbstractDatabaseWindow::Process(lore, rendered);
+	
+	return true;
+}
+
+void QPowerDatabaseWindow::search(void)
+{
+	QAbstractDatabaseWindow::waitForData();
+	
+	const auto fullPack = HexBitsetPack<Number>(QAbstractDatabaseWindow::buttonGroups);
+	const auto nameSearch = QAbstractDatabaseWindow::nameLineEdit->text().toLower();
+	const auto loreSearch = QAbstractDatabaseWindow::loreLineEdit->text().toLower();
+	const auto classSearch = QAbstractDatabaseWindow::classLineEdit->text().toLower();
+	
+	auto query = HexQuery<Number>({ fullPack.getGreenBitset(), fullPack.getRedBitset(), fullPack.getYellowBitsets(), nameSearch, loreSearch, classSearch, QAbstractDatabaseWindow::barNamesButton->isChecked(), QAbstractDatabaseWindow::barTextsButton->isChecked(), QAbstractDatabaseWindow::wordSearchButton->isChecked(), QAbstractDatabaseWindow::rankButton->isChecked() });
+	
+	if (not QAbstractDatabaseWindow::readQuery(query))
+		return;
 	
-	browser->setHtml(qText);
+	query.normalise();
+	
+	// A mistyped class would only find nothing.
+	if (not QPowerDatabaseWindow::powerDatabase.getClassIndex().isValid(query.classSearch))
+	{
+		QAbstractDatabaseWindow::resultLabel->setText("Unknown class, or unreadable levels, in \"" + query.classSearch + "\".");
+		return;
+	}
+	
+	QAbstractDatabaseWindow::runSearch(QPowerDatabaseWindow::powerDatabase, QPowerDatabaseWindow::searchState, query);
+}
+
+std::vector<QAbstractDatabaseWindow::FederatedResult> QPowerDatabaseWindow::searchText(const QString& name, const QString& lore, bool words, const std::function<bool(void)>& cancelled) const
+{
+	return QAbstractDatabaseWindow::SearchText(QPowerDatabaseWindow::powerDatabase, QAbstractDatabaseWindow::databaseName, name, lore, words, cancelled);
+}
+
+void QPowerDatabaseWindow::updateLore(quint32 index, QTextBrowser* browser, const QString& highlight)
+{
+	QAbstractDatabaseWindow::waitForData();
+	QAbstractDatabaseWindow::showLore(index, QPowerDatabaseWindow::powerDatabase.getGeneration(), browser, highlight);
 }
 
 #endif
@@ -4,9 +4,12 @@
 // Qt Libraries
 #include <QGroupBox>
 #include <QShortcut>
+#include <QtConcurrent>
 
 // Custom Libraries
 #include "HexBitsetPack.hpp"
+#include "HexDatabase.hpp"
+#include "HexSearch.hpp"
 #include "QAbstractDatabaseWindow.hpp"
 
 class QSpellDatabaseWindow : public QAbstractDatabaseWindow
@@ -32,15 +35,14 @@ class QSpellDatabaseWindow : public QAbstractDatabaseWindow
 		inline static QColor				Background(const HexBitset<Number>&);
 		inline static QColor				Foreground(const HexBitset<Number>&);
 		
-		std::vector<HexFile<Number>>			allSpells;
-		QFile						spellFile;
-		QTextStream					spellFileStream;
+		HexDatabase<Number>				spellDatabase;
+		SearchState<Number>				searchState;
 		
 		inline void					initialiseAreas(const QFont&, QGridLayout*);
 		inline void					initialiseCastingTimes(const QFont&, QGridLayout*);
 		inline void					initialiseClasses(const QFont&, QGridLayout*);
 		inline void					initialiseControlButtons(const QFont&, QGridLayout*);
-		inline void					initialiseData(void);
+		inline bool					initialiseData(void);
 		inline void					initialiseDescriptors(const QFont&, QGridLayout*);
 		inline void					initialiseDurations(const QFont&, QGridLayout*);
 		inline void					initialiseEffects(const QFont&, QGridLayout*);
@@ -56,9 +58,7 @@ class QSpellDatabaseWindow : public QAbstractDatabaseWindow
 		inline void					initialiseSubschools(const QFont&, QGridLayout*);
 		inline void					initialiseTargets(const QFont&, QGridLayout*);
 		inline void					initialiseTypes(const QFont&, QGridLayout*);
-		inline void					initialiseWidgets(void);
 		inline void					initialiseWindow(const HexFamily&, const QFont&, qint32);
-		inline bool					spellIsValid(const HexFile<Number>&, const HexBitset<Number>&, const HexBitset<Number>&, const std::vector<HexBitset<Number>>&, const QString&, const QString&, bool, bool);
 		
 	protected slots:
 	
@@ -66,26 +66,32 @@ class QSpellDatabaseWindow : public QAbstractDatabaseWindow
 	
 	protected:
 	
+		inline void					addResult(quint32) final;
 		inline void					closeEvent(QCloseEvent*);
-		inline void					updateLore(quint32, QTextBrowser*) final;
+		inline void					finishSearch(void) final;
+		inline void					initialiseWidgets(void) final;
+		inline QListWidgetItem*				makeItem(quint32) const final;
+		inline bool					renderLore(quint32, RenderedLore&) final;
+		inline std::vector<FederatedResult>		searchText(const QString&, const QString&, bool, const std::function<bool(void)>&) const final;
+		inline void					updateLore(quint32, QTextBrowser*, const QString&) final;
 	
 	public:
 	
 		inline						QSpellDatabaseWindow(QWidget*);
+		inline						~QSpellDatabaseWindow(void);
 };
 
 QSpellDatabaseWindow::QSpellDatabaseWindow(QWidget* foo) :
 	QAbstractDatabaseWindow(foo, "spell"),
-	spellFile("files/spells.txt"),
-	spellFileStream(&spellFile)
+	spellDatabase("files/spells.txt", "files/spells.hexdb", SpellClassFieldFirst, SpellClassFieldLast)
 {
-	QSpellDatabaseWindow::initialiseData();
-	QSpellDatabaseWindow::initialiseWidgets();
-	
-	const auto s1 = new QShortcut(QAbstractDatabaseWindow::mainWidget);
-	s1->setKeys({ QKeySequence(Qt::Key_Return), QKeySequence(Qt::Key_Enter) });
-	
-	QObject::connect(s1, SIGNAL(activated(void)), this, SLOT(search(void)));
+	// Only the records are loaded here, on the global thread pool; the widgets wait for the window to be shown.
+	QAbstractDatabaseWindow::dataFuture = QtConcurrent::run([this](void) { return QSpellDatabaseWindow::initialiseData(); });
+}
+
+QSpellDatabaseWindow::~QSpellDatabaseWindow(void)
+{
+	QAbstractDatabaseWindow::closeDatabase();
 }
 
 QColor QSpellDatabaseWindow::Foreground(const HexBitset<Number>& b)
@@ -230,7 +236,7 @@ void QSpellDatabaseWindow::initialiseControlButtons(const QFont& font, QGridLayo
 	const auto filterControlBox = new QGroupBox("Filter Controls", QAbstractDatabaseWindow::mainWidget);
 	const auto filterControlLayout = new QGridLayout();
 	
-	const auto buttonList = { QAbstractDatabaseWindow::barNamesButton, QAbstractDatabaseWindow::keepListButton, QAbstractDatabaseWindow::barTextsButton };
+	const auto buttonList = { QAbstractDatabaseWindow::barNamesButton, QAbstractDatabaseWindow::keepListButton, QAbstractDatabaseWindow::barTextsButton, QAbstractDatabaseWindow::liveSearchButton, QAbstractDatabaseWindow::wordSearchButton, QAbstractDatabaseWindow::rankButton, QAbstractDatabaseWindow::addListButton, QAbstractDatabaseWindow::removeListButton };
 	auto count = 0;
 	
 	for (const auto& btn : buttonList)
@@ -242,10 +248,14 @@ void QSpellDatabaseWindow::initialiseControlButtons(const QFont& font, QGridLayo
 		++count;
 	}
 	
-	filterControlLayout->addWidget(QAbstractDatabaseWindow::resetButton, 1, 1);
+	filterControlLayout->addWidget(QAbstractDatabaseWindow::resetButton, 4, 0, 1, 2);
 	QAbstractDatabaseWindow::resetButton->setObjectName("KL");
 	QAbstractDatabaseWindow::resetButton->setFont(font);
 	
+	filterControlLayout->addWidget(QAbstractDatabaseWindow::searchAllButton, 5, 0, 1, 2);
+	QAbstractDatabaseWindow::searchAllButton->setObjectName("KL");
+	QAbstractDatabaseWindow::searchAllButton->setFont(font);
+	
 	filterControlBox->setLayout(filterControlLayout);
 	layout->addWidget(filterControlBox, 11, 8, 2, 2);
 }
@@ -431,9 +441,11 @@ void QSpellDatabaseWindow::initialiseEverythingElse(const QFont& font, QGridLayo
 	
 	layout->addWidget(QAbstractDatabaseWindow::nameLineEdit, 15, 0, 1, 4);
 	layout->addWidget(QAbstractDatabaseWindow::loreLineEdit, 15, 4, 1, 5);
+	layout->addWidget(QAbstractDatabaseWindow::classLineEdit, 16, 0, 1, 4);
+	layout->addWidget(QAbstractDatabaseWindow::queryLineEdit, 16, 4, 1, 5);
 	layout->addWidget(newGroup.masterButton, 15, 9, 1, 1);
 	
-	layout->addWidget(QAbstractDatabaseWindow::resultList, 0, 10, 16, 7);
+	layout->addWidget(QAbstractDatabaseWindow::resultList, 0, 10, 17, 7);
 	layout->addWidget(QAbstractDatabaseWindow::loreBrowser, 0, 17, 15, 10);
 	layout->addWidget(QAbstractDatabaseWindow::resultLabel, 15, 17, 1, 10);
 	
@@ -1018,34 +1030,31 @@ QColor QSpellDatabaseWindow::Background(const HexBitset<Number>& b)
 	return QSpellDatabaseWindow::UnrevisedColor;
 }
 
+void QSpellDatabaseWindow::addResult(quint32 index)
+{
+	QAbstractDatabaseWindow::resultList->addItem(QSpellDatabaseWindow::makeItem(index));
+}
+
 void QSpellDatabaseWindow::closeEvent(QCloseEvent* e)
 {
 	QWidget::parentWidget()->show();
 	QMainWindow::closeEvent(e);
 }
 
-void QSpellDatabaseWindow::initialiseData(void)
+void QSpellDatabaseWindow::finishSearch(void)
 {
-	if (not QSpellDatabaseWindow::spellFile.open(QIODevice::ReadOnly | QIODevice::Text))
-		std::exit(1);
+	QAbstractDatabaseWindow::endSearch(QSpellDatabaseWindow::spellDatabase, QSpellDatabaseWindow::searchState);
+}
+
+bool QSpellDatabaseWindow::initialiseData(void)
+{
+	if (not QSpellDatabaseWindow::spellDatabase.load())
+		return false;
 	
-	QSpellDatabaseWindow::spellFileStream.seek(0);
-	auto line = 0u;
+	QAbstractDatabaseWindow::nameToIndex = QSpellDatabaseWindow::spellDatabase.getNameToIndex();
+	QAbstractDatabaseWindow::buildNameTree();
 	
-	while (not QSpellDatabaseWindow::spellFileStream.atEnd())
-	{
-		const auto name = QAbstractDatabaseWindow::ExtractString(QSpellDatabaseWindow::spellFile, '@');
-		const auto bset = QAbstractDatabaseWindow::ExtractString(QSpellDatabaseWindow::spellFile, '@');
-		
-		const auto infoPos = QSpellDatabaseWindow::spellFile.pos();
-		const auto info = QAbstractDatabaseWindow::ExtractString(QSpellDatabaseWindow::spellFile, '@');
-		
-		const auto lorePos = QSpellDatabaseWindow::spellFile.pos();
-		const auto lore = QAbstractDatabaseWindow::ExtractString(QSpellDatabaseWindow::spellFile, '\n');
-		
-		QSpellDatabaseWindow::allSpells.emplace_back(name, bset, infoPos, lorePos);
-		QSpellDatabaseWindow::nameToIndex[name] = line++;
-	}
+	return true;
 }
 
 void QSpellDatabaseWindow::initialiseWidgets(void)
@@ -1080,130 +1089,40 @@ void QSpellDatabaseWindow::initialiseWidgets(void)
 	QSpellDatabaseWindow::initialiseEverythingElse(font, layout);
 	
 	QAbstractDatabaseWindow::mainWidget->setLayout(layout);
-}
-
-void QSpellDatabaseWindow::search(void)
-{
-	const auto fullPack = HexBitsetPack<Number>(QAbstractDatabaseWindow::buttonGroups);
-	const auto nameSearch = QAbstractDatabaseWindow::nameLineEdit->text().toLower();
-	const auto loreSearch = QAbstractDatabaseWindow::loreLineEdit->text().toLower();
-	
-	const auto& greenBitset = fullPack.getGreenBitset();
-	const auto& redBitset = fullPack.getRedBitset();
-	const auto& yellowBitsets = fullPack.getYellowBitsets();
-	
-	const auto checkGreen = not greenBitset.null();
-	const auto checkRed = not redBitset.null();
-	
-	auto index = 0u;
-	
-	if (QAbstractDatabaseWindow::keepListButton->isChecked())
-	{
-		auto newSearchResults = std::vector<quint32>();
-		
-		for (const auto& u : QAbstractDatabaseWindow::searchResults)
-		{
-			const auto& file = QSpellDatabaseWindow::allSpells[u];
-			const auto valid = QSpellDatabaseWindow::spellIsValid(file, greenBitset, redBitset, yellowBitsets, nameSearch, loreSearch, checkGreen, checkRed);
-			
-			if (valid)
-				newSearchResults.push_back(index);
-			
-			++index;
-		}
-		
-		QAbstractDatabaseWindow::searchResults.swap(newSearchResults);
-	}
-	else
-	{
-		QAbstractDatabaseWindow::searchResults.clear();
-		
-		for (const auto& file : QSpellDatabaseWindow::allSpells)
-		{
-			const auto valid = QSpellDatabaseWindow::spellIsValid(file, greenBitset, redBitset, yellowBitsets, nameSearch, loreSearch, checkGreen, checkRed);
-			
-			if (valid)
-				QAbstractDatabaseWindow::searchResults.push_back(index);
-			
-			++index;
-		}
-	}
-	
-	QAbstractDatabaseWindow::resultList->clear();
-	
-	for (const auto& u : QSpellDatabaseWindow::searchResults)
-	{
-		const auto& file = QSpellDatabaseWindow::allSpells[u];
-		const auto item = new QListWidgetItem(file.name);
-		
-		const auto backgroundColor = QSpellDatabaseWindow::Background(file.bits);
-		const auto foregroundColor = QSpellDatabaseWindow::Foreground(file.bits);
-		
-		item->setBackground(backgroundColor);
-		item->setForeground(foregroundColor);
-		
-		QAbstractDatabaseWindow::resultList->addItem(item);
-	}
 	
-	const auto size = QSpellDatabaseWindow::searchResults.size();
-	const auto resultString = QString::number(size) + " result" + QString(size > 1u ? "s" : "") + ".";
+	const auto s1 = new QShortcut(QAbstractDatabaseWindow::mainWidget);
+	s1->setKeys({ QKeySequence(Qt::Key_Return), QKeySequence(Qt::Key_Enter) });
 	
-	QAbstractDatabaseWindow::resultLabel->setText(resultString);
+	QObject::connect(s1, SIGNAL(activated(void)), this, SLOT(search(void)));
 }
 
-bool QSpellDatabaseWindow::spellIsValid(const HexFile<Number>& file, const HexBitset<Number>& greenBitset, const HexBitset<Number>& redBitset, const std::vector<HexBitset<Number>>& yellowBitsets, const QString& nameSearch, const QString& loreSearch, bool checkGreen, bool checkRed)
+QListWidgetItem* QSpellDatabaseWindow::makeItem(quint32 index) const
 {
-	if (checkGreen and not file.bits.all(greenBitset))
-		return false;
+	const auto& file = QSpellDatabaseWindow::spellDatabase.getFiles()[index];
+	const auto item = new QListWidgetItem(file.name);
+	item->setData(Qt::UserRole, index);
 	
-	if (checkRed and not file.bits.none(redBitset))
-		return false;
+	const auto backgroundColor = QSpellDatabaseWindow::Background(file.bits);
+	const auto foregroundColor = QSpellDatabaseWindow::Foreground(file.bits);
 	
-	for (const auto& yellowBitset : yellowBitsets)
-	{
-		if (not file.bits.any(yellowBitset))
-			return false;
-	}
+	item->setBackground(backgroundColor);
+	item->setForeground(foregroundColor);
 	
-	if (not nameSearch.isEmpty())
-	{
-		const auto theName = file.name.toLower();
-		
-		if (QAbstractDatabaseWindow::barNamesButton->isChecked() and theName.indexOf(nameSearch) >= 0)
-			return false;
-		
-		if (not QAbstractDatabaseWindow::barNamesButton->isChecked() and theName.indexOf(nameSearch) < 0)
-			return false;
-	}
-	
-	if (not loreSearch.isEmpty())
-	{
-		QSpellDatabaseWindow::spellFileStream.seek(file.textPositionInFile);
-		const auto theLore = QSpellDatabaseWindow::spellFileStream.readLine().toLower();
-		
-		if (QAbstractDatabaseWindow::barTextsButton->isChecked() and theLore.indexOf(loreSearch, Qt::CaseInsensitive) >= 0)
-			return false;
-		
-		if (not QAbstractDatabaseWindow::barTextsButton->isChecked() and theLore.indexOf(loreSearch, Qt::CaseInsensitive) < 0)
-			return false;
-	}
-	
-	return true;
+	return item;
 }
 
-void QSpellDatabaseWindow::updateLore(quint32 index, QTextBrowser* browser)
+// The record as shown, without highlight; false when its line does not read.
+bool QSpellDatabaseWindow::renderLore(quint32 index, RenderedLore& rendered)
 {
-	const auto& file = QSpellDatabaseWindow::allSpells[index];
-	QSpellDatabaseWindow::spellFileStream.seek(file.infoPositionInFile);
-	
-	const auto info = QAbstractDatabaseWindow::ExtractString(QSpellDatabaseWindow::spellFile, '@');
-	const auto infoList = info.split(';');
+	const auto& file = QSpellDatabaseWindow::spellDatabase.getFiles()[index];
+	const auto infoList = QSpellDatabaseWindow::spellDatabase.getInfo(index).split(';');
 	
 	if (infoList.size() != 16u)
-		return;
+		return false;
 	
-	const auto lore = QSpellDatabaseWindow::spellFileStream.readLine();
-	auto qText = "<b>" + file.name + "</b><br>" + infoList.at(0) + "<br>";
+	const auto lore = QSpellDatabaseWindow::spellDatabase.getLoreLine(index);
+	auto& qText = rendered.html;
+	qText = "<b>" + file.name + "</b><br>" + infoList.at(0) + "<br>";
 	
 	if (not infoList.at(1).isEmpty())
 		qText += "<b>Core Classes:</b> " + infoList.at(1) + "<br>";
@@ -1242,9 +1161,46 @@ void QSpellDatabaseWindow::updateLore(quint32 index, QTextBrowser* browser)
 		qText += "<b>Spell Resistance:</b> " + infoList.at(14) + "<br>";
 	
 	qText += "<b>Source:</b> " + infoList.back();
-	qText += QAbstractDatabaseWindow::Process(lore, QAbstractDatabaseWindow::loreLineEdit->text().toLower());
+	QAbstractDatabaseWindow::Process(lore, rendered);
+	
+	return true;
+}
+
+void QSpellDatabaseWindow::search(void)
+{
+	QAbstractDatabaseWindow::waitForData();
+	
+	const auto fullPack = HexBitsetPack<Number>(QAbstractDatabaseWindow::buttonGroups);
+	const auto nameSearch = QAbstractDatabaseWindow::nameLineEdit->text().toLower();
+	const auto loreSearch = QAbstractDatabaseWindow::loreLineEdit->text().toLower();
+	const auto classSearch = QAbstractDatabaseWindow::classLineEdit->text().toLower();
+	
+	auto query = HexQuery<Number>({ fullPack.getGreenBitset(), fullPack.getRedBitset(), fullPack.getYellowBitsets(), nameSearch, loreSearch, classSearch, QAbstractDatabaseWindow::barNamesButton->isChecked(), QAbstractDatabaseWindow::barTextsButton->isChecked(), QAbstractDatabaseWindow::wordSearchButton->isChecked(), QAbstractDatabaseWindow::rankButton->isChecked() });
+	
+	if (not QAbstractDatabaseWindow::readQuery(query))
+		return;
 	
-	browser->setHtml(qText);
+	query.normalise();
+	
+	// A mistyped class would only find nothing.
+	if (not QSpellDatabaseWindow::spellDatabase.getClassIndex().isValid(query.classSearch))
+	{
+		QAbstractDatabaseWindow::resultLabel->setText("Unknown class, or unreadable levels, in \"" + query.classSearch + "\".");
+		return;
+	}
+	
+	QAbstractDatabaseWindow::runSearch(QSpellDatabaseWindow::spellDatabase, QSpellDatabaseWindow::searchState, query);
+}
+
+std::vector<QAbstractDatabaseWindow::FederatedResult> QSpellDatabaseWindow::searchText(const QString& name, const QString& lore, bool words, const std::function<bool(void)>& cancelled) const
+{
+	return QAbstractDatabaseWindow::SearchText(QSpellDatabaseWindow::spellDatabase, QAbstractDatabaseWindow::databaseName, name, lore, words, cancelled);
+}
+
+void QSpellDatabaseWindow::updateLore(quint32 index, QTextBrowser* browser, const QString& highlight)
+{
+	QAbstractDatabaseWindow::waitForData();
+	QAbstractDatabaseWindow::showLore(index, QSpellDatabaseWindow::spellDatabase.getGeneration(), browser, highlight);
 }
 
 #endif
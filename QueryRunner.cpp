@@ -0,0 +1,306 @@
+// C++ Libraries
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// Qt Libraries
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+
+// Custom Libraries
+#include "Enum.hpp"
+#include "HexDatabase.hpp"
+#include "HexParallel.hpp"
+#include "HexQuery.hpp"
+#include "HexQueryPlanner.hpp"
+#include "HexSearch.hpp"
+
+static constexpr auto SpellNumber = static_cast<quint32>(SpellEnum::SIZE);
+static constexpr auto PowerNumber = static_cast<quint32>(PowerEnum::SIZE);
+static constexpr std::size_t RankedResults = 100u;
+
+// One line of the query file: the database, then any of
+//     green:4,152  red:33  yellow:144,145,146  name:"ball"  lore:"ray of"  class:"cleric <= 3"  bar-names  bar-texts  words  ranked  min:1  top:"color spray"
+// Flags are bit numbers of Enum.hpp; every yellow term is one group. A query with min fails the run when it finds fewer results, one with top when its first record has another name.
+// Empty lines and lines starting with '#' are skipped.
+struct HexJob
+{
+	qsizetype				line = 0;
+	bool					powers = false;
+	quint32					minimum = 0u;
+	QString					top;
+	HexQuery<SpellNumber>			spellQuery;
+	HexQuery<PowerNumber>			powerQuery;
+};
+
+// Words of the line, a quoted part being one word without its quotes; \" is a quote kept in the word, for phrases.
+static QStringList Words(const QString& line)
+{
+	auto result = QStringList();
+	auto word = QString();
+	auto quoted = false;
+	auto escaped = false;
+	
+	for (const auto c : line)
+	{
+		if (escaped)
+		{
+			word += c;
+			escaped = false;
+		}
+		else if (c == '\\')
+			escaped = true;
+		else if (c == '"')
+			quoted = not quoted;
+		else if (c.isSpace() and not quoted)
+		{
+			if (not word.isEmpty())
+				result.push_back(word);
+			
+			word.clear();
+		}
+		else
+			word += c;
+	}
+	
+	if (not word.isEmpty())
+		result.push_back(word);
+	
+	return result;
+}
+
+template<quint32 Number>
+static bool ReadBits(const QString& text, HexBitset<Number>& bitset)
+{
+	for (const auto& item : text.split(',', Qt::SkipEmptyParts))
+	{
+		auto ok = false;
+		const auto bit = item.toUInt(&ok);
+		
+		if (not ok or bit >= Number)
+			return false;
+		
+		bitset.setBit(bit);
+	}
+	
+	return true;
+}
+
+template<quint32 Number>
+static bool ReadQuery(const QStringList& words, HexQuery<Number>& query, quint32& minimum, QString& top)
+{
+	for (auto i = qsizetype(1); i < words.size(); ++i)
+	{
+		const auto& word = words.at(i);
+		const auto colon = word.indexOf(':');
+		const auto key = (colon < 0 ? word : word.left(colon));
+		const auto value = (colon < 0 ? QString() : word.sliced(colon + 1));
+		
+		auto ok = true;
+		
+		if (key == "green")
+			ok = ReadBits(value, query.greenBitset);
+		else if (key == "red")
+			ok = ReadBits(value, query.redBitset);
+		else if (key == "yellow")
+			ok = ReadBits(value, query.yellowBitsets.emplace_back());
+		else if (key == "name")
+			query.nameSearch = value.toLower();
+		else if (key == "lore")
+			query.loreSearch = value.toLower();
+		else if (key == "class")
+			query.classSearch = value.toLower();
+		else if (key == "min")
+			minimum = value.toUInt(&ok);
+		else if (key == "top")
+			top = value.toLower();
+		else if (word == "bar-names")
+			query.barNames = true;
+		else if (word == "bar-texts")
+			query.barTexts = true;
+		else if (word == "words")
+			query.wordSearch = true;
+		else if (word == "ranked")
+			query.ranked = true;
+		else
+			ok = false;
+		
+		if (not ok)
+		{
+			std::cerr << "Cannot read \"" << word.toStdString() << "\"";
+			return false;
+		}
+	}
+	
+	query.normalise();
+	return true;
+}
+
+// The records a query returns, in the order shown, planned and run on the calling thread only: the pool runs whole queries side by side.
+template<quint32 Number>
+static std::vector<quint32> Execute(const HexDatabase<Number>& database, const HexQuery<Number>& query)
+{
+	auto planner = HexQueryPlanner<Number>(database.getIndex());
+	planner.plan(query);
+	planner.setThreads(1u);
+	
+	const auto result = HexSearch::Run(database, query, planner, HexBitmap(database.getIndex().size(), true), [](void) { return false; }, [](quint32, const HexBitmap&, quint32, quint32) {});
+	
+	auto records = std::vector<quint32>();
+	
+	if (query.ranked)
+	{
+		for (const auto& [score, index] : database.rank(query.loreSearch, result, RankedResults))
+			records.push_back(index);
+	}
+	else
+		result.forEach([&records](quint32 index) { records.push_back(index); });
+	
+	return records;
+}
+
+static double Percentile(std::vector<qint64> latencies, double rank)
+{
+	if (latencies.empty())
+		return 0.0;
+	
+	const auto position = std::min(latencies.size() - 1u, static_cast<std::size_t>(rank*static_cast<double>(latencies.size())));
+	std::nth_element(latencies.begin(), latencies.begin() + static_cast<qsizetype>(position), latencies.end());
+	
+	return static_cast<double>(latencies[position])/1000.0;
+}
+
+// dnd-query [query file] [rounds]: runs every query of the file the given number of times over the thread pool (DND_THREADS sets its size).
+int main(int argc, char** argv)
+{
+	const auto path = QString(argc > 1 ? argv[1] : "files/queries.txt");
+	const auto rounds = static_cast<quint32>(std::max(argc > 2 ? std::atoi(argv[2]) : 5, 1));
+	
+	auto spells = HexDatabase<SpellNumber>("files/spells.txt", "files/spells.hexdb", SpellClassFieldFirst, SpellClassFieldLast);
+	auto powers = HexDatabase<PowerNumber>("files/powers.txt", "files/powers.hexdb", PowerClassFieldFirst, PowerClassFieldLast);
+	
+	if (not spells.load() or not powers.load())
+	{
+		std::cerr << "Cannot load the databases." << std::endl;
+		return 1;
+	}
+	
+	auto file = QFile(path);
+	
+	if (not file.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		std::cerr << "Cannot read " << path.toStdString() << "." << std::endl;
+		return 1;
+	}
+	
+	auto jobs = std::vector<HexJob>();
+	auto line = qsizetype(0);
+	
+	while (not file.atEnd())
+	{
+		const auto text = QString::fromUtf8(file.readLine()).trimmed();
+		++line;
+		
+		if (text.isEmpty() or text.startsWith('#'))
+			continue;
+		
+		const auto words = Words(text);
+		
+		// A line of nothing but "" reads as no word at all.
+		if (words.empty())
+		{
+			std::cerr << "No database at line " << line << " of " << path.toStdString() << "." << std::endl;
+			return 1;
+		}
+		
+		if (words.front() != "spells" and words.front() != "powers")
+		{
+			std::cerr << "Unknown database \"" << words.front().toStdString() << "\" at line " << line << " of " << path.toStdString() << "." << std::endl;
+			return 1;
+		}
+		
+		auto& job = jobs.emplace_back();
+		job.line = line;
+		job.powers = (words.front() == "powers");
+		
+		if (not (job.powers ? ReadQuery(words, job.powerQuery, job.minimum, job.top) : ReadQuery(words, job.spellQuery, job.minimum, job.top)))
+		{
+			std::cerr << " at line " << line << " of " << path.toStdString() << "." << std::endl;
+			return 1;
+		}
+	}
+	
+	if (jobs.empty())
+	{
+		std::cerr << "No query in " << path.toStdString() << "." << std::endl;
+		return 1;
+	}
+	
+	const auto runs = static_cast<quint32>(jobs.size())*rounds;
+	const auto threads = HexParallel::Threads();
+	
+	auto latencies = std::vector<qint64>(runs);
+	auto counts = std::vector<quint32>(runs);
+	auto firsts = std::vector<quint32>(runs);
+	auto timer = QElapsedTimer();
+	timer.start();
+	
+	HexParallel::For(runs, threads, [&jobs, &latencies, &counts, &firsts, &spells, &powers](quint32 run)
+	{
+		const auto& job = jobs[run % jobs.size()];
+		auto watch = QElapsedTimer();
+		watch.start();
+		
+		const auto records = (job.powers ? Execute(powers, job.powerQuery) : Execute(spells, job.spellQuery));
+		latencies[run] = watch.nsecsElapsed();
+		
+		counts[run] = static_cast<quint32>(records.size());
+		firsts[run] = (records.empty() ? compl(0u) : records.front());
+	});
+	
+	const auto elapsed = static_cast<double>(timer.nsecsElapsed())/1e9;
+	auto mismatches = 0u;
+	auto missing = 0u;
+	
+	std::cout << "line" << std::setw(10) << "database" << std::setw(10) << "results" << std::setw(14) << "p50 (us)" << std::endl;
+	
+	for (auto i = std::size_t(0u); i < jobs.size(); ++i)
+	{
+		auto own = std::vector<qint64>();
+		
+		for (auto run = i; run < runs; run += jobs.size())
+		{
+			own.push_back(latencies[run]);
+			
+			if (counts[run] != counts[i])
+				++mismatches;
+		}
+		
+		if (counts[i] < jobs[i].minimum)
+		{
+			std::cerr << "Line " << jobs[i].line << " found " << counts[i] << " results, fewer than " << jobs[i].minimum << "." << std::endl;
+			++missing;
+		}
+		
+		const auto first = (firsts[i] == compl(0u) ? QString() : (jobs[i].powers ? powers.getFiles()[firsts[i]].name : spells.getFiles()[firsts[i]].name));
+		
+		if (not jobs[i].top.isEmpty() and first.toLower() != jobs[i].top)
+		{
+			std::cerr << "Line " << jobs[i].line << " shows \"" << first.toStdString() << "\" first, not \"" << jobs[i].top.toStdString() << "\"." << std::endl;
+			++missing;
+		}
+		
+		std::cout << std::left << std::setw(4) << jobs[i].line << std::right << std::setw(10) << (jobs[i].powers ? "powers" : "spells") << std::setw(10) << counts[i] << std::setw(14) << std::fixed << std::setprecision(1) << Percentile(own, 0.5) << std::endl;
+	}
+	
+	std::cout << jobs.size() << " queries x " << rounds << " rounds on " << threads << " thread(s): " << std::setprecision(0) << static_cast<double>(runs)/elapsed << " queries/s, p50 " << std::setprecision(1) << Percentile(latencies, 0.5) << " us, p99 " << Percentile(latencies, 0.99) << " us." << std::endl;
+	
+	if (mismatches != 0u)
+		std::cerr << mismatches << " runs returned another number of results than the first round." << std::endl;
+	
+	return (mismatches == 0u and missing == 0u ? 0 : 1);
+}